@@ -105,6 +105,7 @@ namespace Soundux::Objects
                     auto conf = json.get<Config>();
                     data.set(conf.data);
                     settings = conf.settings;
+                    statistics = conf.statistics;
                     Fancy::fancy.logTime().success() << "Config read" << std::endl;
                 }
                 catch (...)
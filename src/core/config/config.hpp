@@ -1,6 +1,8 @@
 #pragma once
 #include <core/objects/data.hpp>
 #include <core/objects/settings.hpp>
+#include <helper/audio/preloader.hpp>
+#include <map>
 #include <string>
 
 namespace Soundux
@@ -11,6 +13,7 @@ namespace Soundux
         {
             Data data;
             Settings settings;
+            std::map<std::string, PlayStatistic> statistics;
 
             void save();
             void load();
@@ -37,6 +37,8 @@ namespace Soundux
             ModifiedDate_Descending,
             Alphabetical_Ascending,
             Alphabetical_Descending,
+            Length_Ascending,
+            Length_Descending,
         };
 
         enum class Theme : std::uint8_t
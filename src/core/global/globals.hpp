@@ -1,7 +1,12 @@
 #pragma once
+#include <helper/audio/activation.hpp>
+#include <helper/audio/analyzer.hpp>
 #include <helper/audio/audio.hpp>
+#include <helper/audio/metadata.hpp>
+#include <helper/audio/preloader.hpp>
 #if defined(__linux__)
 #include <helper/audio/linux/backend.hpp>
+#include <helper/audio/linux/router.hpp>
 #elif defined(_WIN32)
 #include <helper/audio/windows/winsound.hpp>
 #endif
@@ -12,6 +17,7 @@
 #include <core/objects/settings.hpp>
 #include <guard.hpp>
 #include <helper/icons/icons.hpp>
+#include <helper/metrics/metrics.hpp>
 #include <helper/queue/queue.hpp>
 #include <helper/ytdl/youtube-dl.hpp>
 #include <memory>
@@ -27,13 +33,19 @@ namespace Soundux
     {
         inline Objects::Data gData;
         inline Objects::Audio gAudio;
+        inline Objects::Activation gActivation;
+        inline Objects::Analyzer gAnalyzer;
+        inline Objects::MetadataIndex gMetadata;
+        inline Objects::Preloader gPreloader;
 #if defined(__linux__)
         inline std::shared_ptr<Objects::IconFetcher> gIcons;
         inline std::shared_ptr<Objects::AudioBackend> gAudioBackend;
+        inline Objects::Router gRouter;
 #elif defined(_WIN32)
         inline std::shared_ptr<Objects::WinSound> gWinSound;
 #endif
         inline Objects::Queue gQueue;
+        inline Objects::Metrics gMetrics;
         inline Objects::Config gConfig;
         inline Objects::YoutubeDl gYtdl;
         inline Objects::Hotkeys gHotKeys;
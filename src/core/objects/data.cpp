@@ -12,19 +12,28 @@ namespace Soundux::Objects
         for (auto &sound : tabs.back().sounds)
         {
             Globals::gSounds->insert({sound.id, sound});
+            Globals::gAnalyzer.enqueue(sound);
+            Globals::gMetadata.enqueue(sound);
             if (sound.isFavorite)
             {
                 Globals::gFavorites->insert({sound.id, sound});
             }
         }
 
+        index(tabs.back().id);
         return tabs.back();
     }
-    void Data::removeTabById(const std::uint32_t &index)
+    Data::Data(const Data &other)
+        : tabs(other.tabs), isOnFavorites(other.isOnFavorites), width(other.width), height(other.height),
+          soundIdCounter(other.soundIdCounter)
     {
-        if (tabs.size() > index)
+        locations = other.locations.copy();
+    }
+    void Data::removeTabById(const std::uint32_t &tabId)
+    {
+        if (tabs.size() > tabId)
         {
-            auto &tab = tabs.at(index);
+            auto &tab = tabs.at(tabId);
             for (auto &sound : tab.sounds)
             {
                 Globals::gSounds->erase(sound.id);
@@ -34,11 +43,14 @@ namespace Soundux::Objects
                 }
             }
 
-            tabs.erase(tabs.begin() + index);
+            unindex(tab);
+            tabs.erase(tabs.begin() + tabId);
 
-            for (std::size_t i = 0; tabs.size() > i; i++)
+            //* Only the tabs behind the removed one change their id
+            for (std::size_t i = tabId; tabs.size() > i; i++)
             {
                 tabs.at(i).id = i;
+                index(i);
             }
         }
         else
@@ -49,16 +61,20 @@ namespace Soundux::Objects
     void Data::setTabs(const std::vector<Tab> &newTabs)
     {
         tabs = newTabs;
+        locations->clear();
         Globals::gSounds->clear();
         Globals::gFavorites->clear();
         for (std::size_t i = 0; tabs.size() > i; i++)
         {
             auto &tab = tabs.at(i);
             tab.id = i;
+            index(i);
 
             for (auto &sound : tab.sounds)
             {
                 Globals::gSounds->insert({sound.id, sound});
+                Globals::gAnalyzer.enqueue(sound);
+                Globals::gMetadata.enqueue(sound);
                 if (sound.isFavorite)
                 {
                     Globals::gFavorites->insert({sound.id, sound});
@@ -91,6 +107,47 @@ namespace Soundux::Objects
         Fancy::fancy.logTime().warning() << "Tried to access non existent sound " << id << std::endl;
         return std::nullopt;
     }
+    std::optional<SoundLocation> Data::locateSound(const std::uint32_t &id) const
+    {
+        auto scoped = locations.scoped();
+        auto location = scoped->find(id);
+        if (location != scoped->end())
+        {
+            return location->second;
+        }
+
+        return std::nullopt;
+    }
+    std::optional<std::string> Data::getTabName(const std::uint32_t &id) const
+    {
+        if (tabs.size() > id)
+        {
+            return tabs.at(id).name;
+        }
+
+        return std::nullopt;
+    }
+    void Data::index(const std::uint32_t &id)
+    {
+        const auto &tab = tabs.at(id);
+        auto scoped = locations.scoped();
+        for (std::size_t i = 0; tab.sounds.size() > i; i++)
+        {
+            scoped->insert_or_assign(tab.sounds.at(i).id, SoundLocation{id, i});
+        }
+    }
+    void Data::unindex(const Tab &tab)
+    {
+        auto scoped = locations.scoped();
+        for (const auto &sound : tab.sounds)
+        {
+            auto location = scoped->find(sound.id);
+            if (location != scoped->end() && location->second.tabId == tab.id)
+            {
+                scoped->erase(location);
+            }
+        }
+    }
     std::optional<Tab> Data::setTab(const std::uint32_t &id, const Tab &tab)
     {
         if (tabs.size() > id)
@@ -106,11 +163,16 @@ namespace Soundux::Objects
                 }
             }
 
+            unindex(realTab);
             realTab = tab;
+            realTab.id = id;
+            index(id);
 
             for (auto &sound : realTab.sounds)
             {
                 Globals::gSounds->insert({sound.id, sound});
+                Globals::gAnalyzer.enqueue(sound);
+                Globals::gMetadata.enqueue(sound);
                 if (sound.isFavorite)
                 {
                     Globals::gFavorites->insert({sound.id, sound});
@@ -129,6 +191,7 @@ namespace Soundux::Objects
         height = other.height;
         soundIdCounter = other.soundIdCounter;
 
+        locations->clear();
         Globals::gSounds->clear();
         Globals::gFavorites->clear();
 
@@ -136,10 +199,13 @@ namespace Soundux::Objects
         {
             auto &tab = tabs.at(i);
             tab.id = i;
+            index(i);
 
             for (auto &sound : tab.sounds)
             {
                 Globals::gSounds->insert({sound.id, sound});
+                Globals::gAnalyzer.enqueue(sound);
+                Globals::gMetadata.enqueue(sound);
                 if (sound.isFavorite)
                 {
                     Globals::gFavorites->insert({sound.id, sound});
@@ -2,6 +2,9 @@
 #include "objects.hpp"
 #include <cstdint>
 #include <optional>
+#include <string>
+#include <unordered_map>
+#include <var_guard.hpp>
 #include <vector>
 
 namespace nlohmann
@@ -13,18 +16,33 @@ namespace Soundux
 {
     namespace Objects
     {
+        struct SoundLocation
+        {
+            std::uint32_t tabId;
+            //* Index of the sound in the sounds of its tab
+            std::size_t position;
+        };
+
         class Data
         {
             template <typename, typename> friend struct nlohmann::adl_serializer;
 
           private:
             std::vector<Tab> tabs;
+            //* Sound id to the tab that holds it, kept up to date by everything that changes the tabs
+            mutable sxl::var_guard<std::unordered_map<std::uint32_t, SoundLocation>> locations;
+
+            void index(const std::uint32_t &);
+            void unindex(const Tab &);
 
           public:
             bool isOnFavorites = false;
             int width = 1280, height = 720;
             std::uint32_t soundIdCounter = 0;
 
+            Data() = default;
+            Data(const Data &other);
+
             std::vector<Tab> getTabs() const;
             void setTabs(const std::vector<Tab> &);
             bool doesTabExist(const std::string &);
@@ -36,6 +54,9 @@ namespace Soundux
             std::optional<Tab> getTab(const std::uint32_t &) const;
             std::optional<std::reference_wrapper<Sound>> getSound(const std::uint32_t &);
 
+            std::optional<SoundLocation> locateSound(const std::uint32_t &) const;
+            std::optional<std::string> getTabName(const std::uint32_t &) const;
+
             std::vector<Sound> getFavorites();
             std::vector<std::uint32_t> getFavoriteIds();
             void markFavorite(const std::uint32_t &, bool);
@@ -22,6 +22,8 @@ namespace Soundux
 
             std::optional<int> localVolume;
             std::optional<int> remoteVolume;
+            //* Overrides the global trimSilence setting
+            std::optional<bool> trimSilence;
         };
 
         struct Tab
@@ -30,6 +30,16 @@ namespace Soundux
             bool minimizeToTray = false;
             bool tabHotkeysOnly = false;
             bool deleteToTrash = true;
+            bool trimSilence = false;
+            bool normalizeLoudness = false;
+
+            std::uint32_t streamThresholdInMs = 30000;
+            std::uint32_t streamReadAheadInMs = 2000;
+            std::uint32_t routingLingerInMs = 5000;
+            std::uint32_t activationTailInMs = 250;
+            std::uint32_t prepareTtlInMs = 2000;
+            std::uint32_t preloadBudgetInMb = 64;
+            double targetLoudness = -16;
 
 
             // Add these fields to the Settings struct
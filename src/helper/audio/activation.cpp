@@ -0,0 +1,140 @@
+#include "activation.hpp"
+#include <core/global/globals.hpp>
+#include <fancy.hpp>
+
+namespace Soundux::Objects
+{
+    Activation::Activation()
+    {
+        handler = std::thread([this] { handle(); });
+    }
+    Activation::~Activation()
+    {
+        stop = true;
+        cv.notify_all();
+        handler.join();
+    }
+    void Activation::handle()
+    {
+        std::unique_lock lock(mutex);
+        while (!stop)
+        {
+            if (!disengageAt)
+            {
+                cv.wait(lock, [&]() { return disengageAt || stop; });
+                continue;
+            }
+
+            cv.wait_until(lock, *disengageAt, [&]() { return !disengageAt || stop; });
+            if (stop || !disengageAt || std::chrono::steady_clock::now() < *disengageAt)
+            {
+                continue;
+            }
+
+            //* The last voice might have been released while the first one was still engaging
+            if (switching)
+            {
+                cv.wait(lock, [&]() { return !switching || stop; });
+                continue;
+            }
+
+            disengageAt.reset();
+            if (!engaged || voices > 0)
+            {
+                continue;
+            }
+
+            switching = true;
+            lock.unlock();
+
+            disengage();
+
+            lock.lock();
+            engaged = false;
+            switching = false;
+            cv.notify_all();
+        }
+    }
+    void Activation::engage()
+    {
+        if (Globals::gSettings.muteDuringPlayback)
+        {
+#if defined(__linux__)
+            if (Globals::gAudioBackend && !Globals::gAudioBackend->muteInput(true))
+#elif defined(_WIN32)
+            if (Globals::gWinSound && Globals::gWinSound->getMic() && !Globals::gWinSound->getMic()->mute(true))
+#endif
+            {
+                Globals::gGui->onError(Enums::ErrorCode::FailedToMute);
+            }
+        }
+        if (!Globals::gSettings.pushToTalkKeys.empty())
+        {
+            Globals::gHotKeys.pressKeys(Globals::gSettings.pushToTalkKeys);
+        }
+    }
+    void Activation::disengage()
+    {
+        if (!Globals::gSettings.pushToTalkKeys.empty())
+        {
+            Globals::gHotKeys.releaseKeys(Globals::gSettings.pushToTalkKeys);
+        }
+        if (Globals::gSettings.muteDuringPlayback)
+        {
+#if defined(__linux__)
+            if (Globals::gAudioBackend && !Globals::gAudioBackend->muteInput(false))
+#elif defined(_WIN32)
+            if (Globals::gWinSound && Globals::gWinSound->getMic() && !Globals::gWinSound->getMic()->mute(false))
+#endif
+            {
+                Globals::gGui->onError(Enums::ErrorCode::FailedToMute);
+            }
+        }
+    }
+    void Activation::acquire()
+    {
+        voices++;
+
+        std::unique_lock lock(mutex);
+        disengageAt.reset();
+
+        //* Voices that come in while another one engages wait for it, instead of starting right away
+        cv.wait(lock, [&]() { return !switching || stop; });
+        if (engaged || stop)
+        {
+            return;
+        }
+
+        switching = true;
+        lock.unlock();
+
+        engage();
+
+        lock.lock();
+        engaged = true;
+        switching = false;
+        cv.notify_all();
+    }
+    bool Activation::release()
+    {
+        if (voices-- != 1)
+        {
+            return false;
+        }
+
+        std::lock_guard lock(mutex);
+        if (voices == 0 && (engaged || switching))
+        {
+            //* Keeps the keys held for a moment, so that the end of the sound is not cut off
+            disengageAt = std::chrono::steady_clock::now() +
+                          std::chrono::milliseconds(Globals::gSettings.activationTailInMs);
+            cv.notify_all();
+        }
+
+        return true;
+    }
+    bool Activation::isActive() const
+    {
+        return voices > 0;
+    }
+} // namespace Soundux::Objects
@@ -0,0 +1,48 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace Soundux
+{
+    namespace Objects
+    {
+        //* Mutes the microphone and holds the push-to-talk keys for as long as at least one voice is playing.
+        //* The backend and the keyboard are only touched when the first voice starts and, after a short tail, once
+        //* the last one is gone.
+        class Activation
+        {
+            std::atomic<std::uint32_t> voices = 0;
+
+            bool engaged = false;
+            //* Set while the backend and the keyboard are being switched, which happens outside of the lock
+            bool switching = false;
+            std::optional<std::chrono::steady_clock::time_point> disengageAt;
+
+            std::mutex mutex;
+            std::condition_variable cv;
+            std::atomic<bool> stop = false;
+            std::thread handler;
+
+          private:
+            void handle();
+            void engage();
+            void disengage();
+
+          public:
+            Activation();
+            ~Activation();
+
+            //* Blocks until the microphone is muted and the keys are held, so that no voice starts before that
+            void acquire();
+            //* Returns true if this was the last active voice
+            bool release();
+
+            bool isActive() const;
+        };
+    } // namespace Objects
+} // namespace Soundux
@@ -0,0 +1,321 @@
+#include "analyzer.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <core/config/config.hpp>
+#include <core/global/globals.hpp>
+#include <fancy.hpp>
+#include <filesystem>
+#include <miniaudio.h>
+#include <nlohmann/json.hpp>
+#if defined(_WIN32)
+#include <helper/misc/misc.hpp>
+#endif
+
+namespace Soundux::Objects
+{
+#if defined(_WIN32)
+    using Soundux::Helpers::widen;
+#endif
+
+    //* Integrated loudness as described by ITU-R BS.1770 / EBU R128: K-weighting, 400ms blocks with 75% overlap,
+    //* an absolute gate at -70 LUFS and a relative gate 10 LU below the ungated loudness.
+    class LoudnessMeter
+    {
+        struct Biquad
+        {
+            double b0, b1, b2, a1, a2;
+        };
+
+        Biquad shelf{}, highPass{};
+        std::uint32_t channels;
+        std::vector<std::array<double, 4>> state;
+
+        std::uint64_t subBlockFrames;
+        std::uint64_t frames = 0;
+        double sum = 0;
+        std::vector<double> subBlocks;
+
+        static double loudness(double power)
+        {
+            return -0.691 + 10 * std::log10(power);
+        }
+
+      public:
+        LoudnessMeter(std::uint32_t sampleRate, std::uint32_t channels)
+            : channels(channels), state(channels), subBlockFrames(std::max<std::uint64_t>(sampleRate / 10, 1))
+        {
+            const double pi = 3.14159265358979323846;
+            auto rate = static_cast<double>(sampleRate);
+
+            {
+                const double f0 = 1681.974450955533, gain = 3.999843853973347, q = 0.7071752369554196;
+                const double k = std::tan(pi * f0 / rate);
+                const double vh = std::pow(10.0, gain / 20.0);
+                const double vb = std::pow(vh, 0.4996667741545416);
+                const double a0 = 1.0 + k / q + k * k;
+
+                shelf = {(vh + vb * k / q + k * k) / a0, 2.0 * (k * k - vh) / a0, (vh - vb * k / q + k * k) / a0,
+                         2.0 * (k * k - 1.0) / a0, (1.0 - k / q + k * k) / a0};
+            }
+            {
+                const double f0 = 38.13547087602444, q = 0.5003270373238773;
+                const double k = std::tan(pi * f0 / rate);
+                const double a0 = 1.0 + k / q + k * k;
+
+                highPass = {1.0, -2.0, 1.0, 2.0 * (k * k - 1.0) / a0, (1.0 - k / q + k * k) / a0};
+            }
+
+            for (auto &channelState : state)
+            {
+                channelState.fill(0);
+            }
+        }
+
+        void process(const float *samples, std::uint64_t count)
+        {
+            for (std::uint64_t frame = 0; count > frame; frame++)
+            {
+                for (std::uint32_t channel = 0; channels > channel; channel++)
+                {
+                    auto &s = state[channel];
+                    double x = samples[frame * channels + channel];
+
+                    //* Both stages as transposed direct form II
+                    double y = shelf.b0 * x + s[0];
+                    s[0] = shelf.b1 * x - shelf.a1 * y + s[1];
+                    s[1] = shelf.b2 * x - shelf.a2 * y;
+
+                    double z = highPass.b0 * y + s[2];
+                    s[2] = highPass.b1 * y - highPass.a1 * z + s[3];
+                    s[3] = highPass.b2 * y - highPass.a2 * z;
+
+                    sum += z * z;
+                }
+
+                if (++frames == subBlockFrames)
+                {
+                    subBlocks.emplace_back(sum / static_cast<double>(frames));
+                    frames = 0;
+                    sum = 0;
+                }
+            }
+        }
+
+        std::optional<double> integrated()
+        {
+            std::vector<double> blocks;
+            if (subBlocks.size() >= 4)
+            {
+                for (std::size_t i = 0; i + 4 <= subBlocks.size(); i++)
+                {
+                    blocks.emplace_back((subBlocks[i] + subBlocks[i + 1] + subBlocks[i + 2] + subBlocks[i + 3]) / 4);
+                }
+            }
+            else
+            {
+                //* Shorter than one block, which is common for sound effects, so the whole sound is one block
+                auto total = sum;
+                auto count = static_cast<double>(frames);
+                for (const auto &subBlock : subBlocks)
+                {
+                    total += subBlock * static_cast<double>(subBlockFrames);
+                    count += static_cast<double>(subBlockFrames);
+                }
+
+                if (count > 0)
+                {
+                    blocks.emplace_back(total / count);
+                }
+            }
+
+            auto gatedMean = [&](double threshold) -> std::optional<double> {
+                double total = 0;
+                std::size_t count = 0;
+                for (const auto &block : blocks)
+                {
+                    if (block > 0 && loudness(block) > threshold)
+                    {
+                        total += block;
+                        count++;
+                    }
+                }
+
+                if (count == 0)
+                {
+                    return std::nullopt;
+                }
+                return total / static_cast<double>(count);
+            };
+
+            auto absolute = gatedMean(-70.0);
+            if (!absolute)
+            {
+                return std::nullopt;
+            }
+
+            auto relative = gatedMean(loudness(*absolute) - 10.0);
+            if (!relative)
+            {
+                return std::nullopt;
+            }
+
+            return loudness(*relative);
+        }
+    };
+
+    void Analyzer::throttle()
+    {
+        //* Decoding is put on hold while anything plays, so that it never competes with playback
+        while (Globals::gActivation.isActive() && !index.stopping())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    }
+    std::optional<Analysis> Analyzer::analyze(const Job &job)
+    {
+        auto config = ma_decoder_config_init(ma_format_f32, 0, 0);
+
+        ma_decoder decoder;
+#if defined(_WIN32)
+        auto res = ma_decoder_init_file_w(widen(job.path).c_str(), &config, &decoder);
+#else
+        auto res = ma_decoder_init_file(job.path.c_str(), &config, &decoder);
+#endif
+        if (res != MA_SUCCESS)
+        {
+            Fancy::fancy.logTime().warning() << "Failed to analyze " << job.path << std::endl;
+            return std::nullopt;
+        }
+
+        Analysis rtn;
+        rtn.modifiedDate = job.modifiedDate;
+        rtn.sampleRate = decoder.outputSampleRate;
+
+        auto channels = decoder.outputChannels;
+        std::vector<float> buffer(static_cast<std::size_t>(4096) * channels);
+
+        LoudnessMeter meter(decoder.outputSampleRate, channels);
+        WaveformBuilder waveform(channels);
+
+        std::uint64_t position = 0;
+        std::optional<std::uint64_t> firstAudible;
+
+        while (!index.stopping())
+        {
+            throttle();
+
+            auto frames = ma_decoder_read_pcm_frames(&decoder, buffer.data(), 4096);
+            if (frames == 0)
+            {
+                break;
+            }
+
+            meter.process(buffer.data(), frames);
+            waveform.process(buffer.data(), frames);
+
+            if (!firstAudible)
+            {
+                auto end = buffer.begin() + static_cast<std::ptrdiff_t>(frames * channels);
+                auto audible = std::find_if(buffer.begin(), end,
+                                            [](float sample) { return std::fabs(sample) > silenceThreshold; });
+
+                if (audible != end)
+                {
+                    firstAudible = position + static_cast<std::uint64_t>(audible - buffer.begin()) / channels;
+                }
+            }
+
+            position += frames;
+        }
+
+        ma_decoder_uninit(&decoder);
+
+        if (index.stopping())
+        {
+            return std::nullopt;
+        }
+
+        //* Sounds that are silent all the way through are left alone
+        if (firstAudible)
+        {
+            auto leadIn = static_cast<std::uint64_t>(rtn.sampleRate) * leadInMs / 1000;
+            rtn.leadingSilence = *firstAudible > leadIn ? *firstAudible - leadIn : 0;
+        }
+
+        rtn.loudness = meter.integrated();
+        waveforms.store(job.path, waveform.finish(job.modifiedDate));
+
+        return rtn;
+    }
+    std::filesystem::path Analyzer::getPath()
+    {
+        return std::filesystem::u8path(Config::path).parent_path() / "analysis.json";
+    }
+    void Analyzer::load()
+    {
+        waveforms.load();
+        index.load();
+    }
+    void Analyzer::save()
+    {
+        index.save();
+    }
+    void Analyzer::enqueue(const Sound &sound)
+    {
+        index.enqueue(sound.path, sound.modifiedDate);
+    }
+    std::optional<Analysis> Analyzer::get(const Sound &sound)
+    {
+        return index.get(sound.path, sound.modifiedDate);
+    }
+    float Analyzer::getGain(const Sound &sound)
+    {
+        auto analysis = get(sound);
+        if (!analysis || !analysis->loudness)
+        {
+            return 1.f;
+        }
+
+        auto gain = std::pow(10.0, (Globals::gSettings.targetLoudness - *analysis->loudness) / 20.0);
+        return std::min(static_cast<float>(gain), maxGain);
+    }
+
+    std::shared_ptr<const Waveform> Analyzer::getWaveform(const Sound &sound)
+    {
+        return waveforms.get(sound);
+    }
+
+    Analyzer::Analyzer()
+    {
+        BackgroundIndex<Analysis>::Handlers handlers;
+        handlers.process = [this](const Job &job) { return analyze(job); };
+        handlers.isComplete = [this](const std::string &path, std::uint64_t modifiedDate) {
+            return waveforms.has(path, modifiedDate);
+        };
+
+        handlers.toJson = [](const Analysis &analysis) {
+            return nlohmann::json{
+                {"modifiedDate", analysis.modifiedDate},
+                {"sampleRate", analysis.sampleRate},
+                {"leadingSilence", analysis.leadingSilence},
+                {"loudness", analysis.loudness ? nlohmann::json(*analysis.loudness) : nlohmann::json(nullptr)},
+            };
+        };
+        handlers.fromJson = [](const nlohmann::json &entry) {
+            Analysis analysis;
+            entry.at("modifiedDate").get_to(analysis.modifiedDate);
+            entry.at("sampleRate").get_to(analysis.sampleRate);
+            entry.at("leadingSilence").get_to(analysis.leadingSilence);
+
+            if (entry.at("loudness").is_number())
+            {
+                analysis.loudness = entry.at("loudness").get<double>();
+            }
+
+            return analysis;
+        };
+
+        index.start(std::move(handlers), std::clamp<unsigned int>(std::thread::hardware_concurrency() / 2, 1, 4));
+    }
+} // namespace Soundux::Objects
@@ -0,0 +1,65 @@
+#pragma once
+#include <core/objects/objects.hpp>
+#include <helper/audio/index.hpp>
+#include <helper/audio/waveform.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+
+namespace Soundux
+{
+    namespace Objects
+    {
+        struct Analysis
+        {
+            std::uint64_t modifiedDate = 0;
+            std::uint32_t sampleRate = 0;
+
+            //* In frames of the native sample rate
+            std::uint64_t leadingSilence = 0;
+            //* Integrated loudness in LUFS, not set for silent sounds
+            std::optional<double> loudness;
+        };
+
+        //* Decodes sounds on a small pool of background threads and caches what it finds out about them
+        class Analyzer
+        {
+            using Job = BackgroundIndex<Analysis>::Job;
+
+            WaveformCache waveforms;
+
+            //* Declared last, so that the workers are gone before anything they use
+            BackgroundIndex<Analysis> index{"analysis cache", &Analyzer::getPath};
+
+          private:
+            void throttle();
+            std::optional<Analysis> analyze(const Job &);
+
+          public:
+            //* Samples below -50dBFS are considered silent
+            static constexpr float silenceThreshold = 0.00316f;
+            //* Kept in front of the first audible sample, so that the attack is not cut off
+            static constexpr std::uint32_t leadInMs = 5;
+
+            //* Applied gain is limited to +12dB, quiet recordings would otherwise mostly get louder noise
+            static constexpr float maxGain = 4.f;
+
+            Analyzer();
+
+            //* Loads the results of previous runs, has to be called before the first sound is enqueued
+            void load();
+            void save();
+
+            void enqueue(const Sound &);
+            std::optional<Analysis> get(const Sound &);
+
+            //* Gain that brings the sound to the target loudness, 1 if the sound was not analyzed yet
+            float getGain(const Sound &);
+
+            //* Null until the sound was analyzed
+            std::shared_ptr<const Waveform> getWaveform(const Sound &);
+            static std::filesystem::path getPath();
+        };
+    } // namespace Objects
+} // namespace Soundux
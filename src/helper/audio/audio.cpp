@@ -1,6 +1,9 @@
 #include "audio.hpp"
+#include <chrono>
 #include <core/global/globals.hpp>
+#include <cstring>
 #include <fancy.hpp>
+#include <thread>
 #if defined(_WIN32)
 #include <helper/misc/misc.hpp>
 #endif
@@ -32,22 +35,73 @@ namespace Soundux::Objects
             }
 #endif
         }
+
+#if defined(__linux__)
+        finishBusVoices();
+        if (nullSink)
+        {
+            remoteBus.setup(*nullSink);
+        }
+        else
+        {
+            remoteBus.destroy();
+        }
+#endif
     }
     void Audio::destroy()
     {
+        prune(true);
         stopAll();
+        reclaimer.flush();
+        remoteBus.destroy();
     }
-    std::optional<PlayingSound> Audio::play(const Objects::Sound &sound,
-                                            const std::optional<Objects::AudioDevice> &playbackDevice)
+    bool Audio::hasRemoteBus() const
+    {
+        return remoteBus.isRunning();
+    }
+    std::optional<Levels> Audio::getBusLevels() const
+    {
+        if (!remoteBus.isRunning())
+        {
+            return std::nullopt;
+        }
+
+        return remoteBus.getLevels();
+    }
+    std::shared_ptr<Voice> Audio::createVoice(const Objects::Sound &sound,
+                                              const std::optional<Objects::AudioDevice> &playbackDevice)
     {
         static std::atomic<std::uint64_t> id = 0;
 
+        bool onBus = false;
+#if defined(__linux__)
+        //* Remote sounds are mixed into the persistent bus instead of opening their own stream on the null sink
+        onBus = playbackDevice && nullSink && playbackDevice->name == nullSink->name && remoteBus.isRunning();
+#endif
+
+        //* Always decode to float, the fade envelopes are applied to the decoded samples
+        auto decoderConfig = onBus ? ma_decoder_config_init(Bus::format, Bus::channels, Bus::sampleRate)
+                                   : ma_decoder_config_init(ma_format_f32, 0, 0);
+
         auto *decoder = new ma_decoder;
+        bool wasMapped = false;
+        auto mapping = mappings.get(sound, &wasMapped);
+        Globals::gMetrics.count("preload", wasMapped);
+
+        ma_result res = MA_ERROR;
+        if (mapping)
+        {
+            res = ma_decoder_init_memory(mapping->getData(), mapping->getSize(), &decoderConfig, decoder);
+        }
+        if (res != MA_SUCCESS)
+        {
+            mapping = nullptr;
 #if defined(_WIN32)
-        auto res = ma_decoder_init_file_w(widen(sound.path).c_str(), nullptr, decoder);
+            res = ma_decoder_init_file_w(widen(sound.path).c_str(), &decoderConfig, decoder);
 #else
-        auto res = ma_decoder_init_file(sound.path.c_str(), nullptr, decoder);
+            res = ma_decoder_init_file(sound.path.c_str(), &decoderConfig, decoder);
 #endif
+        }
 
         if (res != MA_SUCCESS)
         {
@@ -55,125 +109,380 @@ namespace Soundux::Objects
                 res << std::endl;
             delete decoder;
 
-            return std::nullopt;
+            return nullptr;
         }
 
-        auto *device = new ma_device;
-        auto config = ma_device_config_init(ma_device_type_playback);
+        auto voice = std::make_shared<Voice>();
         auto length_in_pcm_frames = ma_decoder_get_length_in_pcm_frames(decoder);
 
-        config.dataCallback = data_callback;
-        config.sampleRate = decoder->outputSampleRate;
-        config.playback.format = decoder->outputFormat;
-        config.playback.channels = decoder->outputChannels;
+        std::uint64_t offset = 0;
+        if (sound.trimSilence.value_or(Globals::gSettings.trimSilence))
+        {
+            if (auto analysis = Globals::gAnalyzer.get(sound); analysis && analysis->sampleRate > 0)
+            {
+                offset = analysis->leadingSilence * decoder->outputSampleRate / analysis->sampleRate;
+            }
+            else
+            {
+                //* Played untrimmed this time, the next time it will be ready
+                Globals::gAnalyzer.enqueue(sound);
+            }
 
-        auto pSound = std::make_shared<PlayingSound>();
-        config.pUserData = reinterpret_cast<void *>(static_cast<PlayingSound *>(pSound.get()));
+            if (offset >= length_in_pcm_frames ||
+                (offset > 0 && ma_decoder_seek_to_pcm_frame(decoder, offset) != MA_SUCCESS))
+            {
+                offset = 0;
+            }
+        }
 
+        float volume = 1.f;
         if (playbackDevice)
         {
-            config.playback.pDeviceID = &playbackDevice->raw.id;
+            volume = static_cast<float>(sound.remoteVolume ? *sound.remoteVolume : Globals::gSettings.remoteVolume) /
+                     100.f;
         }
         else
         {
-            config.playback.pDeviceID = &defaultPlayback.raw.id;
+            volume = static_cast<float>(sound.localVolume ? *sound.localVolume : Globals::gSettings.localVolume) /
+                     100.f;
         }
 
-        if (ma_device_init(nullptr, &config, device) != MA_SUCCESS)
+        float gain = 1.f;
+        if (Globals::gSettings.normalizeLoudness)
         {
-            Fancy::fancy.logTime().failure() << "Failed to create device" << std::endl;
-            ma_decoder_uninit(decoder);
-            delete decoder;
-            delete device;
-
-            return std::nullopt;
+            //* Sounds that were not analyzed yet are played as they are, getGain takes care of that
+            gain = Globals::gAnalyzer.getGain(sound);
+            Globals::gAnalyzer.enqueue(sound);
         }
+        volume *= gain;
 
-        if (playbackDevice)
+        ma_device *device = nullptr;
+        if (!onBus)
         {
-            if (sound.remoteVolume)
+            device = new ma_device;
+            auto config = ma_device_config_init(ma_device_type_playback);
+
+            config.dataCallback = data_callback;
+            config.sampleRate = decoder->outputSampleRate;
+            config.playback.format = decoder->outputFormat;
+            config.playback.channels = decoder->outputChannels;
+            config.pUserData = reinterpret_cast<void *>(static_cast<Voice *>(voice.get()));
+
+            if (playbackDevice)
             {
-                device->masterVolumeFactor = static_cast<float>(*sound.remoteVolume) / 100.f;
+                config.playback.pDeviceID = &playbackDevice->raw.id;
             }
             else
             {
-                device->masterVolumeFactor = static_cast<float>(Globals::gSettings.remoteVolume) / 100.f;
+                config.playback.pDeviceID = &defaultPlayback.raw.id;
+            }
+
+            if (ma_device_init(nullptr, &config, device) != MA_SUCCESS)
+            {
+                Fancy::fancy.logTime().failure() << "Failed to create device" << std::endl;
+                ma_decoder_uninit(decoder);
+                delete decoder;
+                delete device;
+
+                return nullptr;
+            }
+        }
+
+        auto soundId = ++id;
+
+        auto info = std::make_shared<PlayingSoundInfo>();
+        info->sound = sound;
+        info->offset = offset;
+        info->gain = gain;
+        info->length = length_in_pcm_frames - offset;
+        info->sampleRate = decoder->outputSampleRate;
+        info->playbackDevice = playbackDevice ? *playbackDevice : defaultPlayback;
+        info->lengthInMs = static_cast<std::uint64_t>(static_cast<double>(info->length) /
+                                                      static_cast<double>(info->sampleRate) * 1000);
+
+        voice->id = soundId;
+        voice->info = info;
+        voice->raw.device = device;
+        voice->raw.decoder = decoder;
+        voice->mapping = mapping;
+        //* Applied to the samples by the callback, miniaudio's master volume can not boost
+        voice->state.volume = volume;
+        voice->meter.setup(decoder->outputSampleRate, decoder->outputChannels);
+
+        if (info->lengthInMs > Globals::gSettings.streamThresholdInMs)
+        {
+            auto bufferFrames = static_cast<std::uint32_t>(
+                static_cast<std::uint64_t>(info->sampleRate) * Globals::gSettings.streamReadAheadInMs / 1000);
+
+            voice->stream =
+                Stream::createInstance(decoder->outputFormat, decoder->outputChannels,
+                                       std::max<std::uint32_t>(bufferFrames, decoder->outputSampleRate / 10));
+            if (voice->stream)
+            {
+                streamer.add(voice);
             }
         }
+
+        return voice;
+    }
+    std::optional<PlayingSound> Audio::start(const std::shared_ptr<Voice> &voice)
+    {
+        Globals::gActivation.acquire();
+
+        auto *device = voice->raw.device.load();
+
+        bool started = false;
+        if (device)
+        {
+            started = ma_device_start(device) == MA_SUCCESS;
+        }
         else
         {
-            if (sound.localVolume)
+            started = remoteBus.add(voice.get());
+        }
+
+        if (!started)
+        {
+            Globals::gActivation.release();
+
+            if (voice->stream)
             {
-                device->masterVolumeFactor = static_cast<float>(*sound.localVolume) / 100.f;
+                streamer.remove(voice->id);
             }
-            else
+
+            if (device)
             {
-                device->masterVolumeFactor = static_cast<float>(Globals::gSettings.localVolume) / 100.f;
+                voice->raw.device = nullptr;
+                ma_device_uninit(device);
+                delete device;
             }
-        }
 
-        if (ma_device_start(device) != MA_SUCCESS)
-        {
-            ma_device_uninit(device);
+            auto *decoder = voice->raw.decoder.exchange(nullptr);
             ma_decoder_uninit(decoder);
-
-            delete device;
             delete decoder;
 
-            Fancy::fancy.logTime().warning() << "Failed to play sound " << sound.path << std::endl;
+            Fancy::fancy.logTime().warning() << "Failed to play sound " << voice->info->sound.path << std::endl;
 
             return std::nullopt;
         }
 
-        auto soundId = ++id;
+        playingSounds->emplace(voice->id, voice);
+        notifier.notify();
 
-        pSound->id = soundId;
-        pSound->sound = sound;
-        pSound->raw.device = device;
-        pSound->raw.decoder = decoder;
-        pSound->length = length_in_pcm_frames;
-        pSound->sampleRate = config.sampleRate;
-        pSound->playbackDevice = playbackDevice ? *playbackDevice : defaultPlayback;
-        pSound->lengthInMs = static_cast<std::uint64_t>(static_cast<double>(pSound->length) /
-                                                        static_cast<double>(config.sampleRate) * 1000);
+        return voice->snapshot();
+    }
+    std::optional<PlayingSound> Audio::play(const Objects::Sound &sound,
+                                            const std::optional<Objects::AudioDevice> &playbackDevice)
+    {
+        auto voice = takePrepared(sound, playbackDevice);
+        if (!voice)
+        {
+            voice = createVoice(sound, playbackDevice);
+        }
 
-        playingSounds->emplace(soundId, pSound);
-        return *pSound;
+        if (!voice)
+        {
+            return std::nullopt;
+        }
+
+        return start(voice);
     }
-    void Audio::stopAll()
+    bool Audio::prepare(const Objects::Sound &sound, const std::optional<Objects::AudioDevice> &playbackDevice)
     {
-        auto scoped = playingSounds.scoped();
-        while (!scoped->empty())
+        auto expiresAt =
+            std::chrono::steady_clock::now() + std::chrono::milliseconds(Globals::gSettings.prepareTtlInMs);
+        const auto &deviceName = playbackDevice ? playbackDevice->name : defaultPlayback.name;
+
         {
-            auto &sound = scoped->begin()->second;
-            if (sound->raw.device && sound->raw.decoder)
+            auto scoped = prepared.scoped();
+            for (auto &entry : *scoped)
             {
-                ma_device_uninit(sound->raw.device);
-                ma_decoder_uninit(sound->raw.decoder);
+                const auto &info = *entry.voice->info;
+                if (info.sound.id == sound.id && info.sound.modifiedDate == sound.modifiedDate &&
+                    info.playbackDevice.name == deviceName)
+                {
+                    entry.expiresAt = expiresAt;
+                    return true;
+                }
             }
+        }
+
+        auto voice = createVoice(sound, playbackDevice);
+        if (!voice)
+        {
+            return false;
+        }
 
-            sound->raw.device = nullptr;
-            sound->raw.decoder = nullptr;
+        {
+            auto scoped = prepared.scoped();
+            if (scoped->size() >= maxPrepared)
+            {
+                auto oldest =
+                    std::min_element(scoped->begin(), scoped->end(), [](const auto &first, const auto &second) {
+                        return first.expiresAt < second.expiresAt;
+                    });
+
+                oldest->voice->state.stopping = true;
+                oldest->voice->state.faded = true;
+                reclaimer.push(oldest->voice);
+                scoped->erase(oldest);
+            }
 
-            scoped->erase(sound->id);
+            scoped->emplace_back(Prepared{voice, expiresAt});
         }
+        reclaimer.wake(expiresAt);
+
+        return true;
     }
-    bool Audio::stop(const std::uint32_t &soundId)
+    std::shared_ptr<Voice> Audio::takePrepared(const Objects::Sound &sound,
+                                               const std::optional<Objects::AudioDevice> &playbackDevice)
     {
-        auto scoped = playingSounds.scoped();
-        if (scoped->find(soundId) != scoped->end())
+        const auto &deviceName = playbackDevice ? playbackDevice->name : defaultPlayback.name;
+        auto now = std::chrono::steady_clock::now();
+
+        auto scoped = prepared.scoped();
+        for (auto it = scoped->begin(); it != scoped->end(); it++)
         {
-            auto &sound = scoped->at(soundId);
-            if (sound->raw.device && sound->raw.decoder)
+            const auto &info = *it->voice->info;
+            if (info.sound.id == sound.id && info.sound.modifiedDate == sound.modifiedDate &&
+                info.playbackDevice.name == deviceName && it->expiresAt > now)
             {
-                ma_device_uninit(sound->raw.device);
-                ma_decoder_uninit(sound->raw.decoder);
+                auto voice = std::move(it->voice);
+                scoped->erase(it);
+
+                return voice;
             }
+        }
 
-            sound->raw.device = nullptr;
-            sound->raw.decoder = nullptr;
+        return nullptr;
+    }
+    void Audio::prune(bool all)
+    {
+        auto now = std::chrono::steady_clock::now();
+        std::optional<std::chrono::steady_clock::time_point> next;
 
-            scoped->erase(sound->id);
+        auto scoped = prepared.scoped();
+        for (auto it = scoped->begin(); it != scoped->end();)
+        {
+            if (all || it->expiresAt <= now)
+            {
+                //* The voice never started, so there is nothing to fade out
+                it->voice->state.stopping = true;
+                it->voice->state.faded = true;
+                reclaimer.push(it->voice);
+
+                it = scoped->erase(it);
+                continue;
+            }
+
+            next = next ? std::min(*next, it->expiresAt) : it->expiresAt;
+            it++;
+        }
+
+        if (next)
+        {
+            reclaimer.wake(*next);
+        }
+    }
+    void Audio::release(const std::shared_ptr<Voice> &voice)
+    {
+        //* The audio callback fades the voice out, the actual teardown happens on the reclaimer thread
+        if (voice->state.stopping.exchange(true))
+        {
+            return;
+        }
+
+        reclaimer.push(voice);
+        Globals::gActivation.release();
+    }
+    void Audio::finishBusVoices()
+    {
+        if (!remoteBus.isRunning())
+        {
+            return;
+        }
+
+        {
+            auto scoped = playingSounds.scoped();
+            for (auto it = scoped->begin(); it != scoped->end();)
+            {
+                auto voice = it->second;
+                if (voice->raw.device.load() || !voice->raw.decoder.load())
+                {
+                    it++;
+                    continue;
+                }
+
+                release(voice);
+                if (Globals::gGui)
+                {
+                    Globals::gGui->onSoundFinished(voice->snapshot());
+                }
+                it = scoped->erase(it);
+            }
+        }
+
+        //* The voices are still registered on the bus until they are reclaimed
+        reclaimer.flush();
+    }
+    void Audio::reclaim(Voice &voice)
+    {
+        //* Bounded, in case the device of the voice is not running anymore
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(fadeInMs * 10);
+        while (!voice.state.faded && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        auto *device = voice.raw.device.exchange(nullptr);
+        auto *decoder = voice.raw.decoder.exchange(nullptr);
+
+        if (!decoder)
+        {
+            return;
+        }
+
+        if (device)
+        {
+            ma_device_uninit(device);
+            delete device;
+        }
+        else
+        {
+            remoteBus.remove(&voice);
+        }
+
+        if (voice.stream)
+        {
+            streamer.remove(voice.id);
+        }
+
+        ma_decoder_uninit(decoder);
+        delete decoder;
+    }
+    void Audio::stopAll()
+    {
+        TraceScope scope("stopAll");
+
+        auto scoped = playingSounds.scoped();
+        for (const auto &voice : *scoped)
+        {
+            release(voice.second);
+        }
+
+        scoped->clear();
+    }
+    bool Audio::stop(const std::uint32_t &soundId)
+    {
+        TraceScope scope("stop");
+
+        auto scoped = playingSounds.scoped();
+        if (scoped->find(soundId) != scoped->end())
+        {
+            auto voice = scoped->at(soundId);
+
+            release(voice);
+            scoped->erase(voice->id);
             return true;
         }
 
@@ -186,18 +495,12 @@ namespace Soundux::Objects
         auto scoped = playingSounds.scoped();
         if (scoped->find(soundId) != scoped->end())
         {
-            auto &sound = scoped->at(soundId);
+            auto &voice = scoped->at(soundId);
 
-            if (!sound->paused)
-            {
-                if (ma_device_get_state(sound->raw.device) == MA_STATE_STARTED)
-                {
-                    ma_device_stop(sound->raw.device);
-                }
-                sound->paused = true;
-            }
+            //* The device keeps running, the audio callback fades the voice out and then stays silent
+            voice->state.paused = true;
 
-            return *sound;
+            return voice->snapshot();
         }
 
         Fancy::fancy.logTime().warning() << "Failed to pause sound with id " << soundId << ", sound does not exist"
@@ -209,10 +512,15 @@ namespace Soundux::Objects
         auto scoped = playingSounds.scoped();
         if (scoped->find(soundId) != scoped->end())
         {
-            auto &sound = scoped->at(soundId);
-            sound->repeat = shouldRepeat;
+            auto &voice = scoped->at(soundId);
+            voice->state.repeat = shouldRepeat;
 
-            return *sound;
+            if (voice->stream)
+            {
+                streamer.notify();
+            }
+
+            return voice->snapshot();
         }
 
         Fancy::fancy.logTime().warning() << "Failed to set repeat for sound with id " << soundId
@@ -224,82 +532,122 @@ namespace Soundux::Objects
         auto scoped = playingSounds.scoped();
         if (scoped->find(soundId) != scoped->end())
         {
-            auto &sound = scoped->at(soundId);
+            auto &voice = scoped->at(soundId);
 
-            if (sound->paused)
-            {
-                if (ma_device_get_state(sound->raw.device) == MA_STATE_STOPPED)
-                {
-                    ma_device_start(sound->raw.device);
-                }
-                sound->paused = false;
-            }
+            voice->state.paused = false;
 
-            return *sound;
+            return voice->snapshot();
         }
 
         Fancy::fancy.logTime().warning() << "Failed to resume sound with id " << soundId << ", sound does not exist "
                                          << std::endl;
         return std::nullopt;
     }
-    void Audio::onFinished(PlayingSound sound)
+    bool Audio::setVolume(const std::uint32_t &soundId, float volume)
     {
         auto scoped = playingSounds.scoped();
-        if (scoped->find(sound.id) != scoped->end())
+        if (scoped->find(soundId) != scoped->end())
         {
-            ma_device_uninit(sound.raw.device);
-            ma_decoder_uninit(sound.raw.decoder);
+            auto &voice = scoped->at(soundId);
+            voice->state.volume = volume * voice->info->gain;
 
-            sound.raw.device = nullptr;
-            sound.raw.decoder = nullptr;
+            return true;
+        }
+
+        return false;
+    }
+    void Audio::onFinished(const std::uint32_t &soundId)
+    {
+        auto scoped = playingSounds.scoped();
+        if (scoped->find(soundId) != scoped->end())
+        {
+            auto voice = scoped->at(soundId);
+            release(voice);
 
-            Globals::gGui->onSoundFinished(sound);
-            scoped->erase(sound.id);
+            Globals::gGui->onSoundFinished(voice->snapshot());
+            scoped->erase(soundId);
         }
         else
         {
             Fancy::fancy.logTime().warning() << "Sound finished but is not playing" << std::endl;
         }
     }
-    void Audio::onSoundProgressed(PlayingSound *sound, std::uint64_t frames)
+    void Audio::collectFinished()
     {
-        sound->readFrames += frames;
-        sound->buffer += frames;
+        auto scoped = playingSounds.scoped();
 
-        if (sound->buffer > (sound->sampleRate / 2))
+        std::vector<std::uint32_t> finished;
+        for (const auto &[id, voice] : *scoped)
         {
-            sound->readInMs = static_cast<std::uint64_t>(
-                (static_cast<double>(sound->readFrames) / static_cast<double>(sound->length)) *
-                static_cast<double>(sound->lengthInMs));
+            if (voice->state.finished.load(std::memory_order_acquire))
+            {
+                finished.emplace_back(id);
+            }
+        }
 
-            Globals::gGui->onSoundProgressed(*sound);
+        for (const auto &id : finished)
+        {
+            onFinished(id);
+        }
+    }
+    void Audio::onSoundProgressed(Voice *voice, std::uint64_t frames)
+    {
+        auto &state = voice->state;
+        const auto &info = *voice->info;
+
+        auto readFrames = state.readFrames.load(std::memory_order_relaxed) + frames;
 
-            sound->buffer = 0;
+        //* Repeating sounds loop without going through onSoundSeeked, so we have to wrap the position ourselves
+        if (info.length > 0 && readFrames >= info.length)
+        {
+            if (state.repeat)
+            {
+                readFrames %= info.length;
+            }
+            else
+            {
+                readFrames = info.length;
+            }
         }
+        state.readFrames.store(readFrames, std::memory_order_relaxed);
+
+        //* The gui is updated by the notifier, nothing in here may allocate
+        auto readInMs = static_cast<double>(readFrames) / static_cast<double>(info.length) *
+                        static_cast<double>(info.lengthInMs);
+        state.readInMs.store(static_cast<std::uint64_t>(readInMs), std::memory_order_relaxed);
     }
-    void Audio::onSoundSeeked(PlayingSound *sound, std::uint64_t frame)
+    void Audio::onSoundSeeked(Voice *voice, std::uint64_t frame)
     {
-        sound->shouldSeek = false;
-        sound->readFrames = frame;
-        sound->readInMs = static_cast<std::uint64_t>((static_cast<double>(frame) / static_cast<double>(sound->length)) *
-                                                     static_cast<double>(sound->lengthInMs));
+        const auto &info = *voice->info;
+
+        voice->state.readFrames = frame;
+        voice->state.readInMs = static_cast<std::uint64_t>(
+            (static_cast<double>(frame) / static_cast<double>(info.length)) * static_cast<double>(info.lengthInMs));
     }
     std::optional<PlayingSound> Audio::seek(const std::uint32_t &soundId, std::uint64_t position)
     {
         auto scoped = playingSounds.scoped();
         if (scoped->find(soundId) != scoped->end())
         {
-            auto &sound = scoped->at(soundId);
-            sound->seekTo =
-                static_cast<std::uint64_t>((static_cast<double>(position) / static_cast<double>(sound->lengthInMs)) *
-                                           static_cast<double>(sound->length));
-            sound->shouldSeek = true;
+            auto &voice = scoped->at(soundId);
+            const auto &info = *voice->info;
+
+            auto seekTo = static_cast<std::uint64_t>(
+                (static_cast<double>(position) / static_cast<double>(info.lengthInMs)) *
+                static_cast<double>(info.length));
+
+            voice->state.seekTo = seekTo;
+            voice->state.shouldSeek = true;
+
+            if (voice->stream)
+            {
+                streamer.notify();
+            }
 
-            auto rtn = *sound;
-            rtn.readFrames = rtn.seekTo;
-            rtn.readInMs =
-                static_cast<std::uint64_t>((static_cast<double>(rtn.seekTo) / static_cast<double>(rtn.length)) *
-                                           static_cast<double>(rtn.lengthInMs));
+            auto rtn = voice->snapshot();
+            rtn.readFrames = seekTo;
+            rtn.readInMs = static_cast<std::uint64_t>((static_cast<double>(seekTo) / static_cast<double>(info.length)) *
+                                                      static_cast<double>(info.lengthInMs));
 
             return rtn;
         }
@@ -311,41 +659,183 @@ namespace Soundux::Objects
     void Audio::data_callback(ma_device *device, void *output, [[maybe_unused]] const void *input,
                               std::uint32_t frameCount)
     {
-        auto *sound = reinterpret_cast<PlayingSound *>(device->pUserData);
-        if (!sound)
+        auto *voice = reinterpret_cast<Voice *>(device->pUserData);
+        if (!voice)
         {
             return;
         }
 
-        if (!sound->raw.decoder)
+        read(voice, output, frameCount, ma_get_bytes_per_frame(device->playback.format, device->playback.channels));
+    }
+    std::uint64_t Audio::read(Voice *voice, void *output, std::uint32_t frameCount, std::uint32_t bytesPerFrame)
+    {
+        auto *decoder = voice->raw.decoder.load();
+        if (!decoder)
+        {
+            return 0;
+        }
+
+        auto &state = voice->state;
+        bool audible = !state.paused && !state.stopping;
+
+        if (!audible && state.gain <= 0.f)
+        {
+            //* Fully faded out, the position is kept until the voice is resumed
+            if (state.stopping)
+            {
+                state.faded = true;
+            }
+
+            voice->meter.silence(frameCount);
+            return 0;
+        }
+
+        auto readFrames = voice->stream ? readStream(voice, output, frameCount, bytesPerFrame)
+                                        : readDecoder(voice, decoder, output, frameCount, bytesPerFrame);
+
+        auto channels = bytesPerFrame / static_cast<std::uint32_t>(sizeof(float));
+        applyEnvelope(voice, reinterpret_cast<float *>(output), readFrames, channels, audible);
+
+        voice->meter.process(reinterpret_cast<const float *>(output), readFrames, channels);
+        voice->meter.silence(frameCount - readFrames);
+
+        auto volume = state.volume.load(std::memory_order_relaxed);
+        if (volume != 1.f)
+        {
+            auto *samples = reinterpret_cast<float *>(output);
+            for (std::uint64_t i = 0; readFrames * channels > i; i++)
+            {
+                samples[i] *= volume;
+            }
+        }
+
+        return readFrames;
+    }
+    void Audio::applyEnvelope(Voice *voice, float *output, std::uint64_t frames, std::uint32_t channels, bool audible)
+    {
+        auto &state = voice->state;
+        auto target = audible ? 1.f : 0.f;
+
+        if (state.gain == target)
         {
             return;
         }
 
-        auto readFrames = ma_decoder_read_pcm_frames(sound->raw.decoder, output, frameCount);
-        if (sound->shouldSeek)
+        auto fadeFrames = std::max<std::uint64_t>(voice->info->sampleRate * fadeInMs / 1000, 1);
+        auto step = 1.f / static_cast<float>(fadeFrames);
+
+        for (std::uint64_t frame = 0; frames > frame; frame++)
         {
-            ma_decoder_seek_to_pcm_frame(sound->raw.decoder, sound->seekTo);
-            Globals::gAudio.onSoundSeeked(sound, sound->seekTo);
+            state.gain = audible ? std::min(state.gain + step, 1.f) : std::max(state.gain - step, 0.f);
+            for (std::uint32_t channel = 0; channels > channel; channel++)
+            {
+                output[frame * channels + channel] *= state.gain;
+            }
         }
-        if (sound->playbackDevice.isDefault && readFrames > 0)
+    }
+    std::uint64_t Audio::readDecoder(Voice *voice, ma_decoder *decoder, void *output, std::uint32_t frameCount,
+                                     std::uint32_t bytesPerFrame)
+    {
+        auto &state = voice->state;
+
+        //* Seek before reading so that this period already starts at the requested position
+        if (state.shouldSeek)
         {
-            Globals::gAudio.onSoundProgressed(sound, readFrames);
+            state.shouldSeek = false;
+            ma_decoder_seek_to_pcm_frame(decoder, voice->info->offset + state.seekTo);
+            Globals::gAudio.onSoundSeeked(voice, state.seekTo);
         }
 
-        if (readFrames <= 0)
+        auto *out = reinterpret_cast<std::uint8_t *>(output);
+
+        auto readFrames = ma_decoder_read_pcm_frames(decoder, output, frameCount);
+        while (readFrames < frameCount && state.repeat)
         {
-            if (sound->repeat)
+            //* Wrap around within the same period, the position is wrapped in onSoundProgressed
+            ma_decoder_seek_to_pcm_frame(decoder, voice->info->offset);
+
+            auto loopedFrames = ma_decoder_read_pcm_frames(
+                decoder, out + static_cast<std::size_t>(readFrames) * bytesPerFrame, frameCount - readFrames);
+            if (loopedFrames == 0)
             {
-                ma_decoder_seek_to_pcm_frame(sound->raw.decoder, 0);
-                Globals::gAudio.onSoundSeeked(sound, 0);
+                break;
+            }
+
+            readFrames += loopedFrames;
+        }
+
+        if (voice->info->playbackDevice.isDefault && readFrames > 0)
+        {
+            Globals::gAudio.onSoundProgressed(voice, readFrames);
+        }
+
+        if (readFrames <= 0 && !state.repeat)
+        {
+            //* Nothing left that could be faded out
+            state.gain = 0.f;
+            state.finished.store(true, std::memory_order_release);
+        }
+
+        return readFrames;
+    }
+    std::uint64_t Audio::readStream(Voice *voice, void *output, std::uint32_t frameCount,
+                                    std::uint32_t bytesPerFrame)
+    {
+        auto &stream = *voice->stream;
+
+        if (stream.flush)
+        {
+            //* Drop everything that was decoded before the seek, the output stays silent for this period
+            ma_pcm_rb_reset(&stream.ring);
+            Globals::gAudio.onSoundSeeked(voice, stream.flushTo);
+            stream.flush = false;
+
+            Globals::gAudio.streamer.notify();
+            return 0;
+        }
+
+        auto *out = reinterpret_cast<std::uint8_t *>(output);
+
+        std::uint32_t readFrames = 0;
+        while (readFrames < frameCount)
+        {
+            ma_uint32 frames = frameCount - readFrames;
+            void *buffer = nullptr;
+
+            if (ma_pcm_rb_acquire_read(&stream.ring, &frames, &buffer) != MA_SUCCESS || frames == 0)
+            {
+                break;
+            }
+
+            std::memcpy(out + static_cast<std::size_t>(readFrames) * bytesPerFrame, buffer,
+                        static_cast<std::size_t>(frames) * bytesPerFrame);
+            ma_pcm_rb_commit_read(&stream.ring, frames, buffer);
+
+            readFrames += frames;
+        }
+
+        if (voice->info->playbackDevice.isDefault && readFrames > 0)
+        {
+            Globals::gAudio.onSoundProgressed(voice, readFrames);
+        }
+
+        if (readFrames < frameCount)
+        {
+            if (stream.eof)
+            {
+                if (readFrames == 0)
+                {
+                    voice->state.gain = 0.f;
+                    voice->state.finished.store(true, std::memory_order_release);
+                }
             }
             else
             {
-                Globals::gQueue.push_unique(reinterpret_cast<std::uintptr_t>(device),
-                                            [sound = *sound] { Globals::gAudio.onFinished(sound); });
+                stream.underruns++;
             }
         }
+
+        return readFrames;
     }
     std::vector<AudioDevice> Audio::getAudioDevices()
     {
@@ -424,65 +914,29 @@ namespace Soundux::Objects
         auto scoped = playingSounds.scoped();
 
         std::vector<PlayingSound> rtn;
-        for (const auto &sound : *scoped)
-        {
-            rtn.emplace_back(*sound.second);
-        }
+        rtn.reserve(scoped->size());
 
-        return rtn;
-    }
-    PlayingSound::PlayingSound(const PlayingSound &other)
-    {
-        if (&other == this)
+        for (const auto &voice : *scoped)
         {
-            return;
+            rtn.emplace_back(voice.second->snapshot());
         }
 
-        length = other.length;
-        lengthInMs = other.lengthInMs;
-        readFrames = other.readFrames;
-        sampleRate = other.sampleRate;
-
-        id = other.id;
-        sound = other.sound;
-        buffer = other.buffer;
-
-        seekTo.store(other.seekTo);
-        paused.store(other.paused);
-        repeat.store(other.repeat);
-        readInMs.store(other.readInMs);
-        shouldSeek.store(other.shouldSeek);
-
-        raw.device.store(other.raw.device);
-        raw.decoder.store(other.raw.decoder);
-        playbackDevice = other.playbackDevice;
+        return rtn;
     }
-    PlayingSound &PlayingSound::operator=(const PlayingSound &other)
+    PlayingSound Voice::snapshot() const
     {
-        if (&other == this)
-        {
-            return *this;
-        }
-
-        length = other.length;
-        lengthInMs = other.lengthInMs;
-        readFrames = other.readFrames;
-        sampleRate = other.sampleRate;
+        PlayingSound rtn;
+        rtn.id = id;
+        rtn.info = info;
+        rtn.paused = state.paused.load(std::memory_order_relaxed);
+        rtn.repeat = state.repeat.load(std::memory_order_relaxed);
+        rtn.readInMs = state.readInMs.load(std::memory_order_relaxed);
+        rtn.readFrames = state.readFrames.load(std::memory_order_relaxed);
+
+        auto levels = meter.get();
+        rtn.peak = levels.peak;
+        rtn.rms = levels.rms;
 
-        id = other.id;
-        sound = other.sound;
-        buffer = other.buffer;
-
-        seekTo.store(other.seekTo);
-        paused.store(other.paused);
-        repeat.store(other.repeat);
-        readInMs.store(other.readInMs);
-        shouldSeek.store(other.shouldSeek);
-
-        raw.device.store(other.raw.device);
-        raw.decoder.store(other.raw.decoder);
-        playbackDevice = other.playbackDevice;
-
-        return *this;
+        return rtn;
     }
 } // namespace Soundux::Objects
\ No newline at end of file
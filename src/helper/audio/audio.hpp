@@ -1,7 +1,14 @@
 #pragma once
 #include <atomic>
+#include <chrono>
 #include <core/objects/objects.hpp>
 #include <cstdint>
+#include <helper/audio/bus.hpp>
+#include <helper/audio/mapping.hpp>
+#include <helper/audio/meter.hpp>
+#include <helper/audio/notifier.hpp>
+#include <helper/audio/reclaimer.hpp>
+#include <helper/audio/streamer.hpp>
 #include <map>
 #include <memory>
 #include <miniaudio.h>
@@ -9,6 +16,7 @@
 #include <optional>
 #include <string>
 #include <var_guard.hpp>
+#include <vector>
 
 namespace Soundux
 {
@@ -20,51 +28,137 @@ namespace Soundux
             std::string name;
             bool isDefault;
         };
-        struct PlayingSound
+        //* Immutable description of a playing sound, shared by all snapshots of it
+        struct PlayingSoundInfo
         {
+            Sound sound;
             AudioDevice playbackDevice;
 
-            struct
-            {
-                std::atomic<ma_device *> device;
-                std::atomic<ma_decoder *> decoder;
-            } raw;
-
+            //* Lengths and positions are relative to this frame, it skips the leading silence of trimmed sounds
+            std::uint64_t offset = 0;
             std::uint64_t length = 0;
             std::uint64_t lengthInMs = 0;
-            std::uint64_t readFrames = 0;
             std::uint64_t sampleRate = 0;
 
+            //* Loudness normalization, applied on top of the volume
+            float gain = 1.f;
+        };
+        //* Everything the audio thread touches, kept on its own cache line
+        struct alignas(64) VoiceState
+        {
             std::atomic<bool> paused = false;
             std::atomic<bool> repeat = false;
+            std::atomic<bool> stopping = false;
+            //* Set by the audio thread once a stopping voice is silent
+            std::atomic<bool> faded = false;
+            //* Set by the audio thread once a sound played to its end, picked up by the notifier
+            std::atomic<bool> finished = false;
             std::atomic<bool> shouldSeek = false;
             std::atomic<std::uint64_t> seekTo = 0;
             std::atomic<std::uint64_t> readInMs = 0;
+            std::atomic<std::uint64_t> readFrames = 0;
+            //* Includes the loudness gain, applied to the decoded samples by the audio callback
+            std::atomic<float> volume = 1.f;
 
-            Sound sound;
-            std::uint32_t id;
-            std::uint64_t buffer = 0;
+            //* Only ever touched by the audio thread
+            float gain = 1.f;
+        };
+        //* Cheap copy of the state of a Voice at a given time
+        struct PlayingSound
+        {
+            std::uint32_t id = 0;
+            std::shared_ptr<const PlayingSoundInfo> info;
+
+            bool paused = false;
+            bool repeat = false;
+            std::uint64_t readInMs = 0;
+            std::uint64_t readFrames = 0;
+
+            float peak = 0.f;
+            float rms = 0.f;
+        };
+        struct Voice
+        {
+            std::uint32_t id = 0;
+            VoiceState state;
+            std::shared_ptr<const PlayingSoundInfo> info;
+            //* Measured before the volume is applied
+            Meter meter;
+
+            struct
+            {
+                std::atomic<ma_device *> device;
+                std::atomic<ma_decoder *> decoder;
+            } raw;
 
-            PlayingSound() = default;
-            PlayingSound(const PlayingSound &);
-            PlayingSound &operator=(const PlayingSound &other);
+            //* Only set for sounds that are decoded ahead by the Streamer
+            std::shared_ptr<Stream> stream;
+            //* Backing memory of the decoder, has to outlive it
+            std::shared_ptr<FileMapping> mapping;
+
+            PlayingSound snapshot() const;
         };
         class Audio
         {
-            sxl::var_guard<std::map<std::uint32_t, std::shared_ptr<PlayingSound>>, std::recursive_mutex> playingSounds;
+            friend class Bus;
+            friend class Reclaimer;
+            friend class Preloader;
+            friend class Notifier;
+
+            struct Prepared
+            {
+                std::shared_ptr<Voice> voice;
+                std::chrono::steady_clock::time_point expiresAt;
+            };
+
+            sxl::var_guard<std::map<std::uint32_t, std::shared_ptr<Voice>>, std::recursive_mutex> playingSounds;
+            //* Voices that are ready to be started, so that playing them does not have to open anything
+            sxl::var_guard<std::vector<Prepared>> prepared;
+            Bus remoteBus;
+            Streamer streamer;
+            FileMappings mappings;
+            Reclaimer reclaimer;
+            Notifier notifier;
+
+            //* Length of the gain ramps used for pausing, resuming and stopping
+            static constexpr std::uint32_t fadeInMs = 10;
+            //* Every preparation holds an initialized device, so only a few of them are kept around
+            static constexpr std::size_t maxPrepared = 8;
+
+            std::shared_ptr<Voice> createVoice(const Objects::Sound &, const std::optional<AudioDevice> &);
+            std::shared_ptr<Voice> takePrepared(const Objects::Sound &, const std::optional<AudioDevice> &);
+            std::optional<PlayingSound> start(const std::shared_ptr<Voice> &);
+            //* Drops the preparations that expired, or all of them
+            void prune(bool all = false);
 
-            void onFinished(PlayingSound);
-            void onSoundSeeked(PlayingSound *, std::uint64_t);
-            void onSoundProgressed(PlayingSound *, std::uint64_t);
+            void release(const std::shared_ptr<Voice> &);
+            //* Finishes every voice that is mixed into the bus, has to happen before the bus is replaced
+            void finishBusVoices();
+            void reclaim(Voice &);
+            void onFinished(const std::uint32_t &);
+            //* Finishes the voices that the audio thread marked as finished
+            void collectFinished();
+            void onSoundSeeked(Voice *, std::uint64_t);
+            void onSoundProgressed(Voice *, std::uint64_t);
 
             static void data_callback(ma_device *device, void *output, const void *input, std::uint32_t frameCount);
+            static std::uint64_t read(Voice *voice, void *output, std::uint32_t frameCount, std::uint32_t bytesPerFrame);
+            static std::uint64_t readDecoder(Voice *voice, ma_decoder *decoder, void *output, std::uint32_t frameCount,
+                                             std::uint32_t bytesPerFrame);
+            static void applyEnvelope(Voice *voice, float *output, std::uint64_t frames, std::uint32_t channels,
+                                      bool audible);
+            static std::uint64_t readStream(Voice *voice, void *output, std::uint32_t frameCount,
+                                            std::uint32_t bytesPerFrame);
 
           public:
             std::optional<PlayingSound> pause(const std::uint32_t &);
             std::optional<PlayingSound> resume(const std::uint32_t &);
             std::optional<PlayingSound> repeat(const std::uint32_t &, bool);
             std::optional<PlayingSound> seek(const std::uint32_t &, std::uint64_t);
+            bool setVolume(const std::uint32_t &, float);
             std::optional<PlayingSound> play(const Objects::Sound &, const std::optional<AudioDevice> & = std::nullopt);
+            //* Opens a voice for the sound that a following play picks up, it is dropped if not played in time
+            bool prepare(const Objects::Sound &, const std::optional<AudioDevice> & = std::nullopt);
 
             std::vector<AudioDevice> getAudioDevices();
             std::vector<Objects::PlayingSound> getPlayingSounds();
@@ -75,6 +169,8 @@ namespace Soundux
 
             void setup();
             void destroy();
+            bool hasRemoteBus() const;
+            std::optional<Levels> getBusLevels() const;
 
             void stopAll();
             bool stop(const std::uint32_t &);
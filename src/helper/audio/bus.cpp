@@ -0,0 +1,158 @@
+#include "bus.hpp"
+#include <algorithm>
+#include <core/global/globals.hpp>
+#include <cstring>
+#include <fancy.hpp>
+#include <thread>
+
+namespace Soundux::Objects
+{
+    bool Bus::setup(const AudioDevice &playbackDevice)
+    {
+        destroy();
+
+        auto config = ma_device_config_init(ma_device_type_playback);
+        config.dataCallback = data_callback;
+        config.pUserData = reinterpret_cast<void *>(this);
+        config.sampleRate = sampleRate;
+        config.playback.format = format;
+        config.playback.channels = channels;
+        config.playback.pDeviceID = &playbackDevice.raw.id;
+
+        //* Allocated once so that the audio thread never has to
+        scratch.resize(static_cast<std::size_t>(sampleRate / 10) * channels);
+        meter.setup(sampleRate, channels);
+
+        auto *instance = new ma_device;
+        if (ma_device_init(nullptr, &config, instance) != MA_SUCCESS)
+        {
+            Fancy::fancy.logTime().failure() << "Failed to create bus device for " << playbackDevice.name
+                                             << std::endl;
+            delete instance;
+
+            return false;
+        }
+
+        if (ma_device_start(instance) != MA_SUCCESS)
+        {
+            Fancy::fancy.logTime().failure() << "Failed to start bus device for " << playbackDevice.name
+                                             << std::endl;
+            ma_device_uninit(instance);
+            delete instance;
+
+            return false;
+        }
+
+        device = instance;
+
+        Fancy::fancy.logTime().success() << "Started bus on " << playbackDevice.name << std::endl;
+        return true;
+    }
+    void Bus::destroy()
+    {
+        if (auto *instance = device.exchange(nullptr); instance)
+        {
+            ma_device_uninit(instance);
+            delete instance;
+        }
+
+        for (auto &voice : voices)
+        {
+            voice = nullptr;
+        }
+    }
+    bool Bus::isRunning() const
+    {
+        return device != nullptr;
+    }
+    Levels Bus::getLevels() const
+    {
+        return meter.get();
+    }
+    bool Bus::add(Voice *voice)
+    {
+        for (auto &slot : voices)
+        {
+            Voice *expected = nullptr;
+            if (slot.compare_exchange_strong(expected, voice))
+            {
+                return true;
+            }
+        }
+
+        Fancy::fancy.logTime().warning() << "Bus is full, can not add another voice" << std::endl;
+        return false;
+    }
+    void Bus::remove(Voice *voice)
+    {
+        for (auto &slot : voices)
+        {
+            Voice *expected = voice;
+            slot.compare_exchange_strong(expected, nullptr);
+        }
+
+        //* The epoch is odd while a callback is running, that callback might still be reading the voice
+        auto current = epoch.load();
+        if (current % 2 == 1)
+        {
+            while (epoch.load() == current)
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+    void Bus::data_callback(ma_device *device, void *output, [[maybe_unused]] const void *input,
+                            std::uint32_t frameCount)
+    {
+        auto *bus = reinterpret_cast<Bus *>(device->pUserData);
+        if (!bus)
+        {
+            return;
+        }
+
+        bus->epoch++;
+
+        auto *out = reinterpret_cast<float *>(output);
+        std::memset(out, 0, static_cast<std::size_t>(frameCount) * channels * sizeof(float));
+
+        auto *scratch = bus->scratch.data();
+        auto maxFrames = static_cast<std::uint32_t>(bus->scratch.size() / channels);
+
+        for (auto &slot : bus->voices)
+        {
+            auto *voice = slot.load();
+            if (!voice)
+            {
+                continue;
+            }
+
+            std::uint32_t offset = 0;
+            while (offset < frameCount)
+            {
+                auto frames = std::min(frameCount - offset, maxFrames);
+                std::memset(scratch, 0, static_cast<std::size_t>(frames) * channels * sizeof(float));
+
+                auto readFrames = Audio::read(voice, scratch, frames, channels * sizeof(float));
+                for (std::size_t i = 0; readFrames * channels > i; i++)
+                {
+                    out[offset * channels + i] += scratch[i];
+                }
+
+                if (readFrames < frames)
+                {
+                    break;
+                }
+                offset += frames;
+            }
+        }
+
+        for (std::size_t i = 0; static_cast<std::size_t>(frameCount) * channels > i; i++)
+        {
+            out[i] = std::clamp(out[i], -1.f, 1.f);
+        }
+
+        bus->meter.process(out, frameCount, channels);
+
+        bus->epoch++;
+    }
+} // namespace Soundux::Objects
@@ -0,0 +1,50 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <helper/audio/meter.hpp>
+#include <miniaudio.h>
+#include <vector>
+
+namespace Soundux
+{
+    namespace Objects
+    {
+        struct Voice;
+        struct AudioDevice;
+
+        //* A single, persistent output stream that all voices played on it are mixed into.
+        class Bus
+        {
+            //* Read by isRunning from any thread while setup and destroy replace it
+            std::atomic<ma_device *> device = nullptr;
+
+            std::array<std::atomic<Voice *>, 64> voices{};
+            std::atomic<std::uint64_t> epoch = 0;
+
+            //* Only ever touched by the audio thread
+            std::vector<float> scratch;
+
+            Meter meter;
+
+            static void data_callback(ma_device *device, void *output, const void *input, std::uint32_t frameCount);
+
+          public:
+            static constexpr ma_format format = ma_format_f32;
+            static constexpr std::uint32_t channels = 2;
+            static constexpr std::uint32_t sampleRate = 48000;
+
+            Bus() = default;
+            Bus(const Bus &) = delete;
+            Bus &operator=(const Bus &) = delete;
+
+            bool setup(const AudioDevice &);
+            void destroy();
+            bool isRunning() const;
+            Levels getLevels() const;
+
+            bool add(Voice *);
+            void remove(Voice *);
+        };
+    } // namespace Objects
+} // namespace Soundux
@@ -0,0 +1,234 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fancy.hpp>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <set>
+#include <string>
+#include <thread>
+#include <var_guard.hpp>
+#include <vector>
+
+namespace Soundux
+{
+    namespace Objects
+    {
+        //* Works through sounds on a small pool of background threads and keeps what it found out about them in a
+        //* json file, entries are keyed by path and only valid for as long as the modified date of the sound matches
+        template <typename T> class BackgroundIndex
+        {
+          public:
+            struct Job
+            {
+                std::string path;
+                std::uint64_t modifiedDate;
+            };
+
+            struct Handlers
+            {
+                std::function<std::optional<T>(const Job &)> process;
+
+                std::function<nlohmann::json(const T &)> toJson;
+                std::function<T(const nlohmann::json &)> fromJson;
+
+                //* Optional, for owners that keep more about a sound than the entry itself
+                std::function<bool(const std::string &, std::uint64_t)> isComplete;
+                //* Optional, called from a worker once the queue ran dry and new entries were added
+                std::function<void()> onDrained;
+            };
+
+          private:
+            std::string name;
+            std::filesystem::path (*getPath)();
+            Handlers handlers;
+
+            sxl::var_guard<std::map<std::string, T>> entries;
+            std::atomic<bool> dirty = false;
+            std::atomic<bool> added = false;
+            std::mutex saveMutex;
+
+            std::deque<Job> queue;
+            std::set<std::string> queued;
+            std::mutex queueMutex;
+
+            std::condition_variable cv;
+            std::atomic<bool> stop = false;
+            std::vector<std::thread> workers;
+
+            void handle()
+            {
+                std::unique_lock lock(queueMutex);
+                while (!stop)
+                {
+                    cv.wait(lock, [&]() { return !queue.empty() || stop; });
+                    if (stop)
+                    {
+                        break;
+                    }
+
+                    auto job = std::move(queue.front());
+                    queue.pop_front();
+
+                    lock.unlock();
+                    if (isDone(job.path, job.modifiedDate))
+                    {
+                        lock.lock();
+                        queued.erase(job.path);
+                        continue;
+                    }
+
+                    auto entry = handlers.process(job);
+                    if (entry)
+                    {
+                        entries->insert_or_assign(job.path, *entry);
+                        dirty = true;
+                        added = true;
+                    }
+                    lock.lock();
+
+                    queued.erase(job.path);
+
+                    //* Entries are persisted once the queue runs dry, so that a crash does not lose all of them
+                    if (queue.empty() && queued.empty() && dirty)
+                    {
+                        lock.unlock();
+                        save();
+
+                        if (added.exchange(false) && handlers.onDrained)
+                        {
+                            handlers.onDrained();
+                        }
+                        lock.lock();
+                    }
+                }
+            }
+
+          public:
+            BackgroundIndex(std::string name, std::filesystem::path (*getPath)())
+                : name(std::move(name)), getPath(getPath)
+            {
+            }
+            ~BackgroundIndex()
+            {
+                stop = true;
+                cv.notify_all();
+
+                for (auto &worker : workers)
+                {
+                    worker.join();
+                }
+            }
+
+            //* Has to be called by the owner once it is able to handle jobs
+            void start(Handlers newHandlers, unsigned int count)
+            {
+                handlers = std::move(newHandlers);
+                for (unsigned int i = 0; count > i; i++)
+                {
+                    workers.emplace_back([this] { handle(); });
+                }
+            }
+            bool stopping() const
+            {
+                return stop;
+            }
+
+            void load()
+            {
+                std::ifstream file(getPath());
+                if (!file.is_open())
+                {
+                    return;
+                }
+
+                try
+                {
+                    auto json = nlohmann::json::parse(file);
+                    auto scoped = entries.scoped();
+
+                    for (const auto &[soundPath, entry] : json.items())
+                    {
+                        scoped->insert_or_assign(soundPath, handlers.fromJson(entry));
+                    }
+                }
+                catch (const std::exception &e)
+                {
+                    Fancy::fancy.logTime().warning() << "Failed to load " << name << ": " << e.what() << std::endl;
+                }
+            }
+            void save()
+            {
+                std::lock_guard lock(saveMutex);
+                dirty = false;
+
+                auto json = nlohmann::json::object();
+                for (const auto &[soundPath, entry] : entries.copy())
+                {
+                    json[soundPath] = handlers.toJson(entry);
+                }
+
+                auto path = getPath();
+
+                std::error_code ec;
+                std::filesystem::create_directories(path.parent_path(), ec);
+
+                std::ofstream file(path, std::ios::out | std::ios::trunc);
+                if (!file.is_open())
+                {
+                    Fancy::fancy.logTime().warning() << "Failed to save " << name << " to " << path.u8string()
+                                                     << std::endl;
+                    return;
+                }
+
+                file << json.dump();
+            }
+
+            bool isDone(const std::string &path, std::uint64_t modifiedDate)
+            {
+                if (!get(path, modifiedDate))
+                {
+                    return false;
+                }
+
+                return !handlers.isComplete || handlers.isComplete(path, modifiedDate);
+            }
+            void enqueue(const std::string &path, std::uint64_t modifiedDate)
+            {
+                if (isDone(path, modifiedDate))
+                {
+                    return;
+                }
+
+                std::unique_lock lock(queueMutex);
+                if (!queued.emplace(path).second)
+                {
+                    return;
+                }
+
+                queue.emplace_back(Job{path, modifiedDate});
+                lock.unlock();
+
+                cv.notify_one();
+            }
+            std::optional<T> get(const std::string &path, std::uint64_t modifiedDate)
+            {
+                auto scoped = entries.scoped();
+                auto entry = scoped->find(path);
+                if (entry != scoped->end() && entry->second.modifiedDate == modifiedDate)
+                {
+                    return entry->second;
+                }
+
+                return std::nullopt;
+            }
+        };
+    } // namespace Objects
+} // namespace Soundux
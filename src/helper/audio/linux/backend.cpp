@@ -2,6 +2,8 @@
 #include "backend.hpp"
 #include "pipewire/pipewire.hpp"
 #include "pulseaudio/pulseaudio.hpp"
+#include <chrono>
+#include <cstdlib>
 #include <core/enums/enums.hpp>
 #include <core/global/globals.hpp>
 #include <fancy.hpp>
@@ -9,8 +11,20 @@
 
 namespace Soundux::Objects
 {
+    static void logStartupLatency(const std::string &backend, const std::chrono::steady_clock::time_point &start)
+    {
+        if (std::getenv("SOUNDUX_DEBUG") != nullptr)
+        {
+            auto elapsed =
+                std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+            Fancy::fancy.logTime().message()
+                << "Started " << backend << " backend in " << elapsed.count() << "ms" << std::endl;
+        }
+    }
+
     std::shared_ptr<AudioBackend> AudioBackend::createInstance(Enums::BackendType backend)
     {
+        auto start = std::chrono::steady_clock::now();
         std::shared_ptr<AudioBackend> instance;
         if (backend == Enums::BackendType::PulseAudio)
         {
@@ -23,11 +37,13 @@ namespace Soundux::Objects
                 {
                     if (pulseInstance->loadModules())
                     {
+                        logStartupLatency("PulseAudio", start);
                         return instance;
                     }
                 }
                 else
                 {
+                    logStartupLatency("PulseAudio", start);
                     return instance;
                 }
             }
@@ -44,6 +60,7 @@ namespace Soundux::Objects
             instance = std::shared_ptr<PipeWire>(new PipeWire()); // NOLINT
             if (instance->setup())
             {
+                logStartupLatency("PipeWire", start);
                 return instance;
             }
         }
@@ -49,6 +49,11 @@ namespace Soundux
 
             virtual bool stopSoundInput() = 0;
             virtual bool inputSoundTo(std::shared_ptr<RecordingApp>) = 0;
+            //* Batched versions of the above that only need a single round trip, return the apps that are routed
+            virtual std::set<std::string> inputSoundToAll(const std::vector<std::shared_ptr<RecordingApp>> &) = 0;
+            virtual bool stopSoundInputFor(const std::set<std::string> &) = 0;
+            //* Whether the streams that were routed for the app still exist, answered without a round trip
+            virtual bool isSoundInputLive(const std::string &) = 0;
 
             virtual std::shared_ptr<PlaybackApp> getPlaybackApp(const std::string &) = 0;
             virtual std::shared_ptr<RecordingApp> getRecordingApp(const std::string &) = 0;
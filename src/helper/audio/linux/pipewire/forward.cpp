@@ -33,10 +33,7 @@ bool Soundux::PipeWireApi::setup()
 #define load(name) loadFunc(libpulse, name, stringify(pw_##name))
             load(init);
             load(context_new);
-            load(main_loop_run);
-            load(main_loop_new);
             load(proxy_destroy);
-            load(main_loop_quit);
             load(properties_new);
             load(properties_set);
             load(context_connect);
@@ -44,9 +41,16 @@ bool Soundux::PipeWireApi::setup()
             load(context_destroy);
             load(properties_free);
             load(core_disconnect);
-            load(main_loop_destroy);
-            load(main_loop_get_loop);
+            load(thread_loop_new);
+            load(thread_loop_lock);
+            load(thread_loop_wait);
+            load(thread_loop_stop);
+            load(thread_loop_start);
+            load(thread_loop_unlock);
+            load(thread_loop_signal);
             load(proxy_add_listener);
+            load(thread_loop_destroy);
+            load(thread_loop_get_loop);
             return true;
         }
         catch (std::exception &e)
@@ -2,62 +2,133 @@
 #include "pipewire.hpp"
 #include "forward.hpp"
 #include <fancy.hpp>
+#include <helper/metrics/metrics.hpp>
 #include <memory>
 #include <optional>
 #include <stdexcept>
 
 namespace Soundux::Objects
 {
-    void PipeWire::sync()
+    bool PipeWire::sync()
     {
-        spa_hook coreListener;
-        int pending = 0;
+        //* Expects the loop to be locked, the done event is received on the loop thread which signals us
+        auto pending = pw_core_sync(core, PW_ID_CORE, 0); // NOLINT
+        if (pending < 0)
+        {
+            return false;
+        }
 
-        pw_core_events coreEvents = {};
-        coreEvents.version = PW_VERSION_CORE_EVENTS;
-        coreEvents.done = [](void *data, uint32_t id, int seq) {
-            auto *info = reinterpret_cast<std::pair<PipeWire *, int *> *>(data);
-            if (info)
+        while (lastSync < pending && !coreFailed)
+        {
+            PipeWireApi::thread_loop_wait(loop);
+        }
+
+        return !coreFailed;
+    }
+
+    void PipeWire::onCoreDone(void *data, std::uint32_t id, int seq)
+    {
+        auto *thiz = reinterpret_cast<PipeWire *>(data);
+        if (thiz && id == PW_ID_CORE)
+        {
+            thiz->lastSync = seq;
+            PipeWireApi::thread_loop_signal(thiz->loop, false);
+        }
+    }
+
+    void PipeWire::onCoreError(void *data, std::uint32_t id, int seq, int res, const char *message)
+    {
+        auto *thiz = reinterpret_cast<PipeWire *>(data);
+        if (thiz && id == PW_ID_CORE)
+        {
+            Fancy::fancy.logTime() << "Core Failure - Seq " << seq << " - Res " << res << ": " << message
+                                   << std::endl;
+            thiz->coreFailed = true;
+            PipeWireApi::thread_loop_signal(thiz->loop, false);
+        }
+    }
+
+    void Graph::index(const Node &node)
+    {
+        if (!node.name.empty())
+        {
+            nodesByName[node.name].emplace(node.id);
+        }
+        if (node.pid)
+        {
+            nodesByPid[node.pid].emplace(node.id);
+        }
+    }
+
+    void Graph::unindex(const Node &node)
+    {
+        if (auto byName = nodesByName.find(node.name); byName != nodesByName.end())
+        {
+            byName->second.erase(node.id);
+            if (byName->second.empty())
             {
-                if (id == PW_ID_CORE && seq == *info->second)
-                {
-                    *info->second = -1;
-                    PipeWireApi::main_loop_quit(info->first->loop);
-                }
+                nodesByName.erase(byName);
             }
-        };
-        coreEvents.error = [](void *data, std::uint32_t id, int seq, int res, const char *message) {
-            auto *info = reinterpret_cast<std::pair<PipeWire *, int *> *>(data);
-            if (info)
+        }
+        if (auto byPid = nodesByPid.find(node.pid); byPid != nodesByPid.end())
+        {
+            byPid->second.erase(node.id);
+            if (byPid->second.empty())
             {
-                if (id == PW_ID_CORE && seq == *info->second)
-                {
-                    Fancy::fancy.logTime()
-                        << "Core Failure - Seq " << seq << " - Res " << res << ": " << message << std::endl;
+                nodesByPid.erase(byPid);
+            }
+        }
+    }
+
+    void Graph::index(const Port &port)
+    {
+        if (port.parentNode > 0 && port.side != Side::UNDEFINED)
+        {
+            portsBySide[{port.parentNode, port.direction, port.side}].emplace(port.id);
+        }
+    }
 
-                    *info->second = -1;
-                    PipeWireApi::main_loop_quit(info->first->loop);
+    void Graph::unindex(const Port &port)
+    {
+        if (port.parentNode > 0 && port.side != Side::UNDEFINED)
+        {
+            auto bySide = portsBySide.find({port.parentNode, port.direction, port.side});
+            if (bySide != portsBySide.end())
+            {
+                bySide->second.erase(port.id);
+                if (bySide->second.empty())
+                {
+                    portsBySide.erase(bySide);
                 }
             }
-        };
+        }
+    }
 
-        auto data = std::make_pair(this, &pending);
-        pw_core_add_listener(core, &coreListener, &coreEvents, &data); // NOLINT
+    const std::set<std::uint32_t> &Graph::findPorts(std::uint32_t node, spa_direction direction, Side side) const
+    {
+        static const std::set<std::uint32_t> empty;
 
-        pending = pw_core_sync(core, PW_ID_CORE, 0); // NOLINT
-        while (pending != -1)
+        auto bySide = portsBySide.find({node, direction, side});
+        if (bySide != portsBySide.end())
         {
-            PipeWireApi::main_loop_run(loop);
+            return bySide->second;
         }
 
-        spa_hook_remove(&coreListener);
+        return empty;
     }
 
     void PipeWire::onNodeInfo(const pw_node_info *info)
     {
-        if (info && (~nodes).find(info->id) != (~nodes).end())
+        if (info && info->props)
         {
-            auto &self = (~nodes).at(info->id);
+            auto scopedGraph = graph.scoped();
+            if (scopedGraph->nodes.find(info->id) == scopedGraph->nodes.end())
+            {
+                return;
+            }
+
+            auto &self = scopedGraph->nodes.at(info->id);
+            scopedGraph->unindex(self);
 
             if (const auto *pid = spa_dict_lookup(info->props, "application.process.id"); pid)
             {
@@ -77,14 +148,23 @@ namespace Soundux::Objects
             {
                 self.name = binary;
             }
+
+            scopedGraph->index(self);
         }
     }
 
     void PipeWire::onPortInfo(const pw_port_info *info)
     {
-        if (info && (~ports).find(info->id) != (~ports).end())
+        if (info && info->props)
         {
-            auto &self = (~ports).at(info->id);
+            auto scopedGraph = graph.scoped();
+            if (scopedGraph->ports.find(info->id) == scopedGraph->ports.end())
+            {
+                return;
+            }
+
+            auto &self = scopedGraph->ports.at(info->id);
+            scopedGraph->unindex(self);
             self.direction = info->direction;
 
             if (const auto *nodeId = spa_dict_lookup(info->props, "node.id"); nodeId)
@@ -112,6 +192,13 @@ namespace Soundux::Objects
             {
                 self.portAlias = std::string(portAlias);
             }
+
+            scopedGraph->index(self);
+
+            if (auto node = scopedGraph->nodes.find(self.parentNode); node != scopedGraph->nodes.end())
+            {
+                node->second.ports.insert_or_assign(self.id, self);
+            }
         }
     }
 
@@ -142,104 +229,90 @@ namespace Soundux::Objects
         auto *thiz = reinterpret_cast<PipeWire *>(data);
         if (thiz && props)
         {
-            if (strcmp(type, PW_TYPE_INTERFACE_Core) == 0)
-            {
-                spa_hook listener;
-                pw_core_events events = {};
-
-                events.info = [](void *data, const pw_core_info *info) {
-                    auto *thiz = reinterpret_cast<PipeWire *>(data);
-                    if (thiz)
-                    {
-                        thiz->onCoreInfo(info);
-                    }
-                };
-                events.version = PW_VERSION_CORE_EVENTS;
-                auto *boundCore = reinterpret_cast<pw_core *>(
-                    pw_registry_bind(thiz->registry, id, type, PW_VERSION_CORE, sizeof(PipeWire)));
-
-                if (boundCore)
-                {
-                    pw_core_add_listener(boundCore, &listener, &events, thiz); // NOLINT
-                    thiz->sync();
-                    spa_hook_remove(&listener);
-                    PipeWireApi::proxy_destroy(reinterpret_cast<pw_proxy *>(boundCore));
-                }
-            }
             if (strcmp(type, PW_TYPE_INTERFACE_Node) == 0)
             {
                 const auto *name = spa_dict_lookup(props, PW_KEY_NODE_NAME);
                 if (name && strstr(name, "soundux"))
                 {
+                    if (strcmp(name, "soundux_sink") == 0)
+                    {
+                        thiz->graph->sink = id;
+                    }
                     return;
                 }
 
-                Node node;
-                node.id = id;
-
-                spa_hook listener;
-                pw_node_events events = {};
+                static pw_node_events events = [] {
+                    pw_node_events events = {};
+                    events.version = PW_VERSION_NODE_EVENTS;
+                    events.info = [](void *data, const pw_node_info *info) {
+                        auto *thiz = reinterpret_cast<PipeWire *>(data);
+                        if (thiz)
+                        {
+                            thiz->onNodeInfo(info);
+                        }
+                    };
+                    return events;
+                }();
 
-                events.info = [](void *data, const pw_node_info *info) {
-                    auto *thiz = reinterpret_cast<PipeWire *>(data);
-                    if (thiz)
-                    {
-                        thiz->onNodeInfo(info);
-                    }
-                };
-                events.version = PW_VERSION_NODE_EVENTS;
                 auto *boundNode = reinterpret_cast<pw_node *>(
                     pw_registry_bind(thiz->registry, id, type, PW_VERSION_NODE, sizeof(PipeWire)));
 
                 if (boundNode)
                 {
-                    thiz->nodes->emplace(id, node);
-                    pw_node_add_listener(boundNode, &listener, &events, thiz); // NOLINT
-                    thiz->sync();
-                    spa_hook_remove(&listener);
-                    PipeWireApi::proxy_destroy(reinterpret_cast<pw_proxy *>(boundNode));
+                    Node node;
+                    node.id = id;
+
+                    {
+                        auto scopedGraph = thiz->graph.scoped();
+
+                        //* Ports may be announced before the node they belong to
+                        for (const auto &[portId, port] : scopedGraph->ports)
+                        {
+                            if (port.parentNode == id)
+                            {
+                                node.ports.emplace(portId, port);
+                            }
+                        }
+
+                        scopedGraph->nodes.insert_or_assign(id, node);
+                    }
+
+                    auto bound = std::make_unique<BoundProxy>();
+                    bound->proxy = reinterpret_cast<pw_proxy *>(boundNode);
+                    pw_node_add_listener(boundNode, &bound->listener, &events, thiz); // NOLINT
+
+                    thiz->boundProxies.insert_or_assign(id, std::move(bound));
                 }
             }
             if (strcmp(type, PW_TYPE_INTERFACE_Port) == 0)
             {
-                Port port;
-                port.id = id;
-
-                spa_hook listener;
-                pw_port_events events = {};
-
-                events.info = [](void *data, const pw_port_info *info) {
-                    auto *thiz = reinterpret_cast<PipeWire *>(data);
-                    if (thiz)
-                    {
-                        thiz->onPortInfo(info);
-                    }
-                };
-                events.version = PW_VERSION_PORT_EVENTS;
+                static pw_port_events events = [] {
+                    pw_port_events events = {};
+                    events.version = PW_VERSION_PORT_EVENTS;
+                    events.info = [](void *data, const pw_port_info *info) {
+                        auto *thiz = reinterpret_cast<PipeWire *>(data);
+                        if (thiz)
+                        {
+                            thiz->onPortInfo(info);
+                        }
+                    };
+                    return events;
+                }();
 
                 auto *boundPort =
                     reinterpret_cast<pw_port *>(pw_registry_bind(thiz->registry, id, type, version, sizeof(PipeWire)));
 
                 if (boundPort)
                 {
-                    thiz->ports->emplace(id, port);
-                    pw_port_add_listener(boundPort, &listener, &events, thiz); // NOLINT
-                    thiz->sync();
-                    spa_hook_remove(&listener);
-                    PipeWireApi::proxy_destroy(reinterpret_cast<pw_proxy *>(boundPort));
-
-                    auto scopedNodes = thiz->nodes.scoped();
-                    auto scopedPorts = thiz->ports.scoped();
-                    if (scopedPorts->find(id) != scopedPorts->end())
-                    {
-                        auto &port = scopedPorts->at(id);
-                        if (port.parentNode > 0 && scopedNodes->find(port.parentNode) != scopedNodes->end())
-                        {
-                            auto &node = scopedNodes->at(port.parentNode);
-                            node.ports.emplace(id, port);
-                            scopedPorts->erase(id);
-                        }
-                    }
+                    Port port;
+                    port.id = id;
+                    thiz->graph->ports.insert_or_assign(id, port);
+
+                    auto bound = std::make_unique<BoundProxy>();
+                    bound->proxy = reinterpret_cast<pw_proxy *>(boundPort);
+                    pw_port_add_listener(boundPort, &bound->listener, &events, thiz); // NOLINT
+
+                    thiz->boundProxies.insert_or_assign(id, std::move(bound));
                 }
             }
         }
@@ -250,16 +323,34 @@ namespace Soundux::Objects
         auto *thiz = reinterpret_cast<PipeWire *>(data);
         if (thiz)
         {
-            auto scopedNodes = thiz->nodes.scoped();
-            if (scopedNodes->find(id) != scopedNodes->end())
+            if (auto bound = thiz->boundProxies.find(id); bound != thiz->boundProxies.end())
+            {
+                spa_hook_remove(&bound->second->listener);
+                PipeWireApi::proxy_destroy(bound->second->proxy);
+                thiz->boundProxies.erase(bound);
+            }
+
+            auto scopedGraph = thiz->graph.scoped();
+            if (scopedGraph->sink == id)
             {
-                scopedNodes->erase(id);
+                scopedGraph->sink = 0;
             }
 
-            auto scopedPorts = thiz->ports.scoped();
-            if (scopedPorts->find(id) != scopedPorts->end())
+            if (auto node = scopedGraph->nodes.find(id); node != scopedGraph->nodes.end())
             {
-                scopedPorts->erase(id);
+                scopedGraph->unindex(node->second);
+                scopedGraph->nodes.erase(node);
+            }
+
+            if (auto port = scopedGraph->ports.find(id); port != scopedGraph->ports.end())
+            {
+                scopedGraph->unindex(port->second);
+                if (auto node = scopedGraph->nodes.find(port->second.parentNode); node != scopedGraph->nodes.end())
+                {
+                    node->second.ports.erase(id);
+                }
+
+                scopedGraph->ports.erase(port);
             }
         }
     }
@@ -272,28 +363,52 @@ namespace Soundux::Objects
         }
 
         PipeWireApi::init(nullptr, nullptr);
-        loop = PipeWireApi::main_loop_new(nullptr);
+        loop = PipeWireApi::thread_loop_new("soundux", nullptr);
         if (!loop)
         {
-            Fancy::fancy.logTime().failure() << "Failed to create main loop" << std::endl;
+            Fancy::fancy.logTime().failure() << "Failed to create thread loop" << std::endl;
             return false;
         }
-        context = PipeWireApi::context_new(PipeWireApi::main_loop_get_loop(loop), nullptr, 0);
+        context = PipeWireApi::context_new(PipeWireApi::thread_loop_get_loop(loop), nullptr, 0);
         if (!context)
         {
             Fancy::fancy.logTime().failure() << "Failed to create context" << std::endl;
             return false;
         }
+        if (PipeWireApi::thread_loop_start(loop) != 0)
+        {
+            Fancy::fancy.logTime().failure() << "Failed to start thread loop" << std::endl;
+            return false;
+        }
+
+        PipeWireApi::thread_loop_lock(loop);
+
         core = PipeWireApi::context_connect(context, nullptr, 0);
         if (!core)
         {
             Fancy::fancy.logTime().failure() << "Failed to connect context" << std::endl;
+            PipeWireApi::thread_loop_unlock(loop);
             return false;
         }
+
+        coreEvents = {};
+        coreEvents.version = PW_VERSION_CORE_EVENTS;
+        coreEvents.done = onCoreDone;
+        coreEvents.error = onCoreError;
+        coreEvents.info = [](void *data, const pw_core_info *info) {
+            auto *thiz = reinterpret_cast<PipeWire *>(data);
+            if (thiz)
+            {
+                thiz->onCoreInfo(info);
+            }
+        };
+        pw_core_add_listener(core, &coreListener, &coreEvents, this); // NOLINT
+
         registry = pw_core_get_registry(core, PW_VERSION_REGISTRY, 0);
         if (!registry)
         {
             Fancy::fancy.logTime().failure() << "Failed to get registry" << std::endl;
+            PipeWireApi::thread_loop_unlock(loop);
             return false;
         }
 
@@ -303,17 +418,38 @@ namespace Soundux::Objects
 
         pw_registry_add_listener(registry, &registryListener, &registryEvents, this); // NOLINT
 
-        sync();
+        //* The first round trip collects all globals, the second one all info events of the proxies bound by them
+        if (!sync() || !sync())
+        {
+            Fancy::fancy.logTime().failure() << "Failed to sync with pipewire" << std::endl;
+            PipeWireApi::thread_loop_unlock(loop);
+            return false;
+        }
+
+        auto success = createNullSink();
+        PipeWireApi::thread_loop_unlock(loop);
 
-        return createNullSink();
+        return success;
     }
 
     void PipeWire::destroy()
     {
+        PipeWireApi::thread_loop_stop(loop);
+
+        for (auto &[id, bound] : boundProxies)
+        {
+            spa_hook_remove(&bound->listener);
+            PipeWireApi::proxy_destroy(bound->proxy);
+        }
+        boundProxies.clear();
+
+        spa_hook_remove(&registryListener);
+        spa_hook_remove(&coreListener);
+
         PipeWireApi::proxy_destroy(reinterpret_cast<pw_proxy *>(registry));
         PipeWireApi::core_disconnect(core);
         PipeWireApi::context_destroy(context);
-        PipeWireApi::main_loop_destroy(loop);
+        PipeWireApi::thread_loop_destroy(loop);
     }
 
     bool PipeWire::createNullSink()
@@ -345,7 +481,12 @@ namespace Soundux::Objects
         };
 
         PipeWireApi::proxy_add_listener(proxy, &listener, &linkEvent, &success);
-        sync();
+
+        //* Also wait for the info events of the sink ports
+        if (!sync() || !sync())
+        {
+            success = false;
+        }
 
         spa_hook_remove(&listener);
         PipeWireApi::properties_free(props);
@@ -353,61 +494,140 @@ namespace Soundux::Objects
         return success;
     }
 
-    bool PipeWire::deleteLink(std::uint32_t id)
+    void PipeWire::deleteLinks(const std::vector<std::uint32_t> &ids)
     {
-        pw_registry_destroy(registry, id); // NOLINT
-        sync();
+        if (ids.empty())
+        {
+            return;
+        }
 
-        return true;
+        PipeWireApi::thread_loop_lock(loop);
+        for (const auto &id : ids)
+        {
+            pw_registry_destroy(registry, id); // NOLINT
+        }
+        sync();
+        PipeWireApi::thread_loop_unlock(loop);
     }
 
-    std::optional<int> PipeWire::linkPorts(std::uint32_t in, std::uint32_t out)
+    std::vector<std::optional<std::uint32_t>> PipeWire::linkPorts(
+        const std::vector<std::pair<std::uint32_t, std::uint32_t>> &links)
     {
-        pw_properties *props = PipeWireApi::properties_new(nullptr, nullptr);
+        struct PendingLink
+        {
+            spa_hook listener;
+            pw_properties *props;
+            pw_proxy *proxy = nullptr;
+            std::optional<std::uint32_t> result;
+        };
 
-        PipeWireApi::properties_set(props, PW_KEY_APP_NAME, "soundux");
-        PipeWireApi::properties_setf(props, PW_KEY_LINK_INPUT_PORT, "%u", in);
-        PipeWireApi::properties_setf(props, PW_KEY_LINK_OUTPUT_PORT, "%u", out);
+        static pw_proxy_events linkEvent = [] {
+            pw_proxy_events linkEvent = {};
+            linkEvent.version = PW_VERSION_PROXY_EVENTS;
+            linkEvent.bound = [](void *data, std::uint32_t id) { reinterpret_cast<PendingLink *>(data)->result = id; };
+            linkEvent.error = [](void *data, [[maybe_unused]] int a, [[maybe_unused]] int b, const char *message) {
+                Fancy::fancy.logTime().warning() << "Failed to create link: " << message << std::endl;
+                reinterpret_cast<PendingLink *>(data)->result = std::nullopt;
+            };
+            return linkEvent;
+        }();
 
-        auto *proxy = reinterpret_cast<pw_proxy *>(
-            pw_core_create_object(core, "link-factory", PW_TYPE_INTERFACE_Link, PW_VERSION_LINK, &props->dict, 0));
+        //* The listeners are referenced by the loop until removed, so the storage must not move
+        auto pending = std::make_unique<PendingLink[]>(links.size());
 
-        if (!proxy)
+        PipeWireApi::thread_loop_lock(loop);
+        for (std::size_t i = 0; links.size() > i; i++)
         {
-            Fancy::fancy.logTime().warning() << "Failed to create link from " << in << " to " << out << std::endl;
-            PipeWireApi::properties_free(props);
-            return std::nullopt;
+            const auto &[in, out] = links[i];
+            auto &link = pending[i];
+
+            link.props = PipeWireApi::properties_new(nullptr, nullptr);
+            PipeWireApi::properties_set(link.props, PW_KEY_APP_NAME, "soundux");
+            PipeWireApi::properties_setf(link.props, PW_KEY_LINK_INPUT_PORT, "%u", in);
+            PipeWireApi::properties_setf(link.props, PW_KEY_LINK_OUTPUT_PORT, "%u", out);
+
+            link.proxy = reinterpret_cast<pw_proxy *>(pw_core_create_object(
+                core, "link-factory", PW_TYPE_INTERFACE_Link, PW_VERSION_LINK, &link.props->dict, 0));
+
+            if (!link.proxy)
+            {
+                Fancy::fancy.logTime().warning() << "Failed to create link from " << in << " to " << out << std::endl;
+                continue;
+            }
+
+            PipeWireApi::proxy_add_listener(link.proxy, &link.listener, &linkEvent, &link);
         }
 
-        spa_hook listener;
-        std::optional<std::uint32_t> result;
+        if (!links.empty())
+        {
+            sync();
+        }
 
-        pw_proxy_events linkEvent = {};
-        linkEvent.version = PW_VERSION_PROXY_EVENTS;
-        linkEvent.bound = [](void *data, std::uint32_t id) {
-            *reinterpret_cast<std::optional<std::uint32_t> *>(data) = id;
-        };
-        linkEvent.error = [](void *data, [[maybe_unused]] int a, [[maybe_unused]] int b, const char *message) {
-            Fancy::fancy.logTime().warning() << "Failed to create link: " << message << std::endl;
-            *reinterpret_cast<std::optional<std::uint32_t> *>(data) = std::nullopt;
-        };
+        std::vector<std::optional<std::uint32_t>> rtn;
+        rtn.reserve(links.size());
 
-        PipeWireApi::proxy_add_listener(proxy, &listener, &linkEvent, &result);
-        sync();
+        for (std::size_t i = 0; links.size() > i; i++)
+        {
+            auto &link = pending[i];
+            if (link.proxy)
+            {
+                spa_hook_remove(&link.listener);
+            }
 
-        spa_hook_remove(&listener);
-        PipeWireApi::properties_free(props);
+            PipeWireApi::properties_free(link.props);
+            rtn.emplace_back(link.result);
+        }
+        PipeWireApi::thread_loop_unlock(loop);
+
+        return rtn;
+    }
 
-        return result;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> PipeWire::findSinkPorts(const std::string &name,
+                                                                                 spa_direction direction)
+    {
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> rtn;
+        auto sinkDirection = direction == SPA_DIRECTION_INPUT ? SPA_DIRECTION_OUTPUT : SPA_DIRECTION_INPUT;
+
+        auto scopedGraph = graph.scoped();
+        auto byName = scopedGraph->nodesByName.find(name);
+        if (byName == scopedGraph->nodesByName.end() || !scopedGraph->sink)
+        {
+            return rtn;
+        }
+
+        for (const auto &nodeId : byName->second)
+        {
+            for (const auto &side : {Side::LEFT, Side::RIGHT, Side::MONO})
+            {
+                for (const auto &sinkPort : scopedGraph->findPorts(scopedGraph->sink, sinkDirection, side))
+                {
+                    //* Mono ports of the app are connected to every side of the sink
+                    for (const auto &nodePort : scopedGraph->findPorts(nodeId, direction, side))
+                    {
+                        rtn.emplace_back(nodePort, sinkPort);
+                    }
+                    if (side != Side::MONO)
+                    {
+                        for (const auto &nodePort : scopedGraph->findPorts(nodeId, direction, Side::MONO))
+                        {
+                            rtn.emplace_back(nodePort, sinkPort);
+                        }
+                    }
+                }
+            }
+        }
+
+        return rtn;
     }
 
     std::vector<std::shared_ptr<RecordingApp>> PipeWire::getRecordingApps()
     {
-        sync();
+        TraceScope scope("getRecordingApps");
+
         std::vector<std::shared_ptr<RecordingApp>> rtn;
 
-        auto scopedNodes = nodes.scoped();
-        for (const auto &[nodeId, node] : *scopedNodes)
+        auto scopedGraph = graph.scoped();
+        for (const auto &[nodeId, node] : scopedGraph->nodes)
         {
             if (!node.applicationBinary.empty() && !node.isMonitor)
             {
@@ -438,11 +658,12 @@ namespace Soundux::Objects
 
     std::vector<std::shared_ptr<PlaybackApp>> PipeWire::getPlaybackApps()
     {
-        sync();
+        TraceScope scope("getPlaybackApps");
+
         std::vector<std::shared_ptr<PlaybackApp>> rtn;
 
-        auto scopedNodes = nodes.scoped();
-        for (const auto &[nodeId, node] : *scopedNodes)
+        auto scopedGraph = graph.scoped();
+        for (const auto &[nodeId, node] : scopedGraph->nodes)
         {
             if (!node.applicationBinary.empty() && !node.isMonitor)
             {
@@ -473,16 +694,19 @@ namespace Soundux::Objects
 
     std::shared_ptr<PlaybackApp> PipeWire::getPlaybackApp(const std::string &name)
     {
-        auto scopedNodes = nodes.scoped();
-        for (const auto &[nodeId, node] : *scopedNodes)
+        TraceScope scope("getPlaybackApp");
+
+        auto scopedGraph = graph.scoped();
+        if (auto byName = scopedGraph->nodesByName.find(name); byName != scopedGraph->nodesByName.end())
         {
-            if (node.name == name)
+            auto nodeId = *byName->second.begin();
+            if (auto node = scopedGraph->nodes.find(nodeId); node != scopedGraph->nodes.end())
             {
                 PipeWirePlaybackApp app;
-                app.pid = node.pid;
+                app.pid = node->second.pid;
                 app.nodeId = nodeId;
-                app.name = node.name;
-                app.application = node.applicationBinary;
+                app.name = node->second.name;
+                app.application = node->second.applicationBinary;
                 return std::make_shared<PipeWirePlaybackApp>(app);
             }
         }
@@ -492,16 +716,19 @@ namespace Soundux::Objects
 
     std::shared_ptr<RecordingApp> PipeWire::getRecordingApp(const std::string &name)
     {
-        auto scopedNodes = nodes.scoped();
-        for (const auto &[nodeId, node] : *scopedNodes)
+        TraceScope scope("getRecordingApp");
+
+        auto scopedGraph = graph.scoped();
+        if (auto byName = scopedGraph->nodesByName.find(name); byName != scopedGraph->nodesByName.end())
         {
-            if (node.name == name)
+            auto nodeId = *byName->second.begin();
+            if (auto node = scopedGraph->nodes.find(nodeId); node != scopedGraph->nodes.end())
             {
                 PipeWireRecordingApp app;
-                app.pid = node.pid;
+                app.pid = node->second.pid;
                 app.nodeId = nodeId;
-                app.name = node.name;
-                app.application = node.applicationBinary;
+                app.name = node->second.name;
+                app.application = node->second.applicationBinary;
                 return std::make_shared<PipeWireRecordingApp>(app);
             }
         }
@@ -525,6 +752,8 @@ namespace Soundux::Objects
 
     bool PipeWire::muteInput(bool state)
     {
+        TraceScope scope("muteInput");
+
         // TODO(pipewire): Maybe we could delete any link from the microphone to the output app and recreate it?
         Fancy::fancy.logTime().warning() << "Fix Me: muteInput() is not yet implemented on pipewire" << std::endl;
 
@@ -539,83 +768,129 @@ namespace Soundux::Objects
             Fancy::fancy.logTime().warning() << "Invalid app" << std::endl;
             return false;
         }
-        if (soundInputLinks.count(app->name))
-        {
-            return true;
-        }
 
-        auto pipeWireApp = std::dynamic_pointer_cast<PipeWireRecordingApp>(app);
-        if (!pipeWireApp)
-        {
-            Fancy::fancy.logTime().warning() << "Supplied app was not a Recording App" << std::endl;
-            return false;
-        }
+        return inputSoundToAll({app}).count(app->name) > 0;
+    }
 
-        bool success = false;
-        auto nodes = this->nodes.copy();
-        auto ports = this->ports.copy();
+    std::set<std::string> PipeWire::inputSoundToAll(const std::vector<std::shared_ptr<RecordingApp>> &apps)
+    {
+        TraceScope scope("inputSoundToAll");
 
-        if (!soundInputLinks.count(app->name))
-        {
-            soundInputLinks.emplace(app->name, std::vector<std::uint32_t>{});
-        }
+        std::set<std::string> rtn;
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> links;
+        //* Every app with the amount of port pairs it contributed to `links`
+        std::vector<std::pair<std::shared_ptr<PipeWireRecordingApp>, std::size_t>> pending;
 
-        for (const auto &[nodeId, node] : nodes)
+        for (const auto &app : apps)
         {
-            if (node.name != app->name)
+            if (!app)
+            {
                 continue;
-
-            for (const auto &[portId, port] : ports)
+            }
+            if (soundInputLinks.count(app->name))
             {
-                if (port.direction == SPA_DIRECTION_OUTPUT && port.portAlias.find("soundux") != std::string::npos)
+                if (isSoundInputLive(app->name))
                 {
-                    for (const auto &[nodePortId, nodePort] : node.ports)
-                    {
-                        if (nodePort.direction == SPA_DIRECTION_INPUT)
-                        {
-                            if (nodePort.side == Side::UNDEFINED || port.side == Side::UNDEFINED)
-                                continue;
+                    rtn.emplace(app->name);
+                    continue;
+                }
 
-                            if (nodePort.side == port.side || nodePort.side == Side::MONO)
-                            {
-                                auto link = linkPorts(nodePortId, portId);
+                //* The node went away and took its links with it, the app has to be linked again
+                soundInputLinks.erase(app->name);
+                soundInputNodes.erase(app->name);
+            }
 
-                                if (link)
-                                {
-                                    success = true;
-                                    soundInputLinks.at(app->name).emplace_back(*link);
-                                }
-                            }
-                        }
-                    }
+            auto pipeWireApp = std::dynamic_pointer_cast<PipeWireRecordingApp>(app);
+            if (!pipeWireApp)
+            {
+                Fancy::fancy.logTime().warning() << "Supplied app was not a Recording App" << std::endl;
+                continue;
+            }
+
+            auto ports = findSinkPorts(app->name, SPA_DIRECTION_INPUT);
+            links.insert(links.end(), ports.begin(), ports.end());
+            pending.emplace_back(pipeWireApp, ports.size());
+        }
+
+        //* All outputs are linked in a single round trip
+        auto results = linkPorts(links);
+
+        std::size_t offset = 0;
+        for (const auto &[app, count] : pending)
+        {
+            std::vector<std::uint32_t> bound;
+            for (std::size_t i = offset; offset + count > i; i++)
+            {
+                if (results[i])
+                {
+                    bound.emplace_back(*results[i]);
                 }
             }
+            offset += count;
+
+            //* Only remember the app once it is actually linked, otherwise the next call would report a success
+            if (bound.empty())
+            {
+                Fancy::fancy.logTime().warning() << "Could not find ports for app " << app->name << std::endl;
+                continue;
+            }
+
+            soundInputLinks.insert_or_assign(app->name, bound);
+            soundInputNodes.insert_or_assign(app->name, app->nodeId);
+            rtn.emplace(app->name);
         }
 
-        if (!success)
+        return rtn;
+    }
+
+    bool PipeWire::isSoundInputLive(const std::string &name)
+    {
+        auto node = soundInputNodes.find(name);
+        if (node == soundInputNodes.end())
         {
-            Fancy::fancy.logTime().warning() << "Could not find ports for app " << app->name << std::endl;
+            return false;
         }
 
-        return success;
+        auto scopedGraph = graph.scoped();
+        return scopedGraph->nodes.find(node->second) != scopedGraph->nodes.end();
     }
 
     bool PipeWire::stopSoundInput()
     {
+        std::set<std::string> names;
         for (const auto &[appName, links] : soundInputLinks)
         {
-            for (const auto &id : links)
+            names.emplace(appName);
+        }
+
+        return stopSoundInputFor(names);
+    }
+
+    bool PipeWire::stopSoundInputFor(const std::set<std::string> &names)
+    {
+        TraceScope scope("stopSoundInputFor");
+
+        std::vector<std::uint32_t> ids;
+        for (const auto &name : names)
+        {
+            if (auto links = soundInputLinks.find(name); links != soundInputLinks.end())
             {
-                deleteLink(id);
+                ids.insert(ids.end(), links->second.begin(), links->second.end());
+                soundInputLinks.erase(links);
             }
+            soundInputNodes.erase(name);
         }
-        soundInputLinks.clear();
+
+        //* All links are deleted in a single round trip
+        deleteLinks(ids);
 
         return true;
     }
 
     bool PipeWire::passthroughFrom(std::shared_ptr<PlaybackApp> app)
     {
+        TraceScope scope("passthroughFrom");
+
         if (!app)
         {
             Fancy::fancy.logTime().warning() << "Invalid app" << std::endl;
@@ -630,43 +905,23 @@ namespace Soundux::Objects
         }
 
         bool success = false;
-        auto nodes = this->nodes.copy();
-        auto ports = this->ports.copy();
-
         if (!passthroughLinks.count(app->name))
         {
             passthroughLinks.emplace(app->name, std::vector<std::uint32_t>{});
         }
 
-        for (const auto &[nodeId, node] : nodes)
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> links;
+        for (const auto &[nodePort, sinkPort] : findSinkPorts(app->name, SPA_DIRECTION_OUTPUT))
         {
-            if (node.name != app->name)
-                continue;
+            links.emplace_back(sinkPort, nodePort);
+        }
 
-            for (const auto &[portId, port] : ports)
+        for (const auto &link : linkPorts(links))
+        {
+            if (link)
             {
-                if (port.direction == SPA_DIRECTION_INPUT && port.portAlias.find("soundux") != std::string::npos)
-                {
-                    for (const auto &[nodePortId, nodePort] : node.ports)
-                    {
-                        if (nodePort.side == Side::UNDEFINED || port.side == Side::UNDEFINED)
-                            continue;
-
-                        if (nodePort.direction == SPA_DIRECTION_OUTPUT)
-                        {
-                            if (nodePort.side == port.side || nodePort.side == Side::MONO)
-                            {
-                                auto link = linkPorts(portId, nodePortId);
-
-                                if (link)
-                                {
-                                    success = true;
-                                    passthroughLinks.at(app->name).emplace_back(*link);
-                                }
-                            }
-                        }
-                    }
-                }
+                success = true;
+                passthroughLinks.at(app->name).emplace_back(*link);
             }
         }
 
@@ -701,13 +956,11 @@ namespace Soundux::Objects
 
     bool PipeWire::stopPassthrough(const std::string &name)
     {
+        TraceScope scope("stopPassthrough");
+
         if (passthroughLinks.find(name) != passthroughLinks.end())
         {
-            for (const auto &id : passthroughLinks.at(name))
-            {
-                deleteLink(id);
-            }
-
+            deleteLinks(passthroughLinks.at(name));
             passthroughLinks.erase(name);
         }
         else
@@ -720,14 +973,15 @@ namespace Soundux::Objects
 
     bool PipeWire::stopAllPassthrough()
     {
+        TraceScope scope("stopAllPassthrough");
+
+        std::vector<std::uint32_t> ids;
         for (const auto &[appName, links] : passthroughLinks)
         {
-            for (const auto &id : links)
-            {
-                deleteLink(id);
-            }
+            ids.insert(ids.end(), links.begin(), links.end());
         }
 
+        deleteLinks(ids);
         passthroughLinks.clear();
         return true;
     }
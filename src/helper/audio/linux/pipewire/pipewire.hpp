@@ -1,8 +1,12 @@
 #if defined(__linux__)
 #include "../backend.hpp"
 #include <map>
+#include <memory>
 #include <optional>
 #include <pipewire/pipewire.h>
+#include <set>
+#include <tuple>
+#include <unordered_map>
 #include <var_guard.hpp>
 
 // TODO(pipewire):
@@ -37,12 +41,33 @@ namespace Soundux
         {
             std::uint32_t id;
             std::string name;
-            std::uint32_t pid;
+            std::uint32_t pid = 0;
             bool isMonitor = false;
             std::string applicationBinary;
             std::map<std::uint32_t, Port> ports;
         };
 
+        struct Graph
+        {
+            std::map<std::uint32_t, Node> nodes;
+            std::map<std::uint32_t, Port> ports;
+
+            //* Id of our null sink, its node is not part of `nodes` but its ports are indexed like any other
+            std::uint32_t sink = 0;
+
+            std::unordered_map<std::string, std::set<std::uint32_t>> nodesByName;
+            std::unordered_map<std::uint32_t, std::set<std::uint32_t>> nodesByPid;
+            std::map<std::tuple<std::uint32_t, spa_direction, Side>, std::set<std::uint32_t>> portsBySide;
+
+            void index(const Node &);
+            void unindex(const Node &);
+
+            void index(const Port &);
+            void unindex(const Port &);
+
+            const std::set<std::uint32_t> &findPorts(std::uint32_t, spa_direction, Side) const;
+        };
+
         struct PipeWirePlaybackApp : public PlaybackApp
         {
             std::uint32_t pid;
@@ -62,17 +87,32 @@ namespace Soundux
 
           private:
             pw_core *core;
-            pw_main_loop *loop;
             pw_context *context;
             pw_registry *registry;
+            pw_thread_loop *loop;
             std::uint32_t version = 0;
 
+            spa_hook coreListener;
+            pw_core_events coreEvents;
+
             spa_hook registryListener;
             pw_registry_events registryEvents;
 
+            //* Only ever touched while holding the loop lock
+            int lastSync = 0;
+            //* Set once the core reported an error, no more done events are to be expected after that
+            bool coreFailed = false;
+
           private:
-            sxl::var_guard<std::map<std::uint32_t, Node>> nodes;
-            sxl::var_guard<std::map<std::uint32_t, Port>> ports;
+            //* Nodes and Ports stay bound for as long as they exist so that their info events keep the model current
+            struct BoundProxy
+            {
+                pw_proxy *proxy;
+                spa_hook listener;
+            };
+            std::map<std::uint32_t, std::unique_ptr<BoundProxy>> boundProxies;
+
+            sxl::var_guard<Graph> graph;
 
             void onNodeInfo(const pw_node_info *);
             void onPortInfo(const pw_port_info *);
@@ -80,13 +120,22 @@ namespace Soundux
 
           private:
             std::map<std::string, std::vector<std::uint32_t>> soundInputLinks;
+            //* Node the links of each app were created for, used to notice when an app re-created its node
+            std::map<std::string, std::uint32_t> soundInputNodes;
             std::map<std::string, std::vector<std::uint32_t>> passthroughLinks;
 
           private:
-            void sync();
+            bool sync();
             bool createNullSink();
-            bool deleteLink(std::uint32_t);
-            std::optional<int> linkPorts(std::uint32_t, std::uint32_t);
+            std::vector<std::pair<std::uint32_t, std::uint32_t>> findSinkPorts(const std::string &, spa_direction);
+
+            //* Both issue all requests at once and wait for a single round trip
+            void deleteLinks(const std::vector<std::uint32_t> &);
+            std::vector<std::optional<std::uint32_t>> linkPorts(
+                const std::vector<std::pair<std::uint32_t, std::uint32_t>> &);
+
+            static void onCoreDone(void *, std::uint32_t, int);
+            static void onCoreError(void *, std::uint32_t, int, int, const char *);
 
             static void onGlobalRemoved(void *, std::uint32_t);
             static void onGlobalAdded(void *, std::uint32_t, std::uint32_t, const char *, std::uint32_t,
@@ -112,6 +161,9 @@ namespace Soundux
 
             bool stopSoundInput() override;
             bool inputSoundTo(std::shared_ptr<RecordingApp> app) override;
+            std::set<std::string> inputSoundToAll(const std::vector<std::shared_ptr<RecordingApp>> &apps) override;
+            bool stopSoundInputFor(const std::set<std::string> &names) override;
+            bool isSoundInputLive(const std::string &name) override;
 
             std::shared_ptr<PlaybackApp> getPlaybackApp(const std::string &name) override;
             std::shared_ptr<RecordingApp> getRecordingApp(const std::string &name) override;
@@ -19,10 +19,22 @@ bool Soundux::PulseApi::setup()
 {
 #if defined(USE_FLATPAK)
 #define load(name) name = reinterpret_cast<decltype(name)>(pa_##name);
-    load(mainloop_new);
-    load(mainloop_iterate);
-    load(mainloop_get_api);
+    load(threaded_mainloop_new);
+    load(threaded_mainloop_free);
+    load(threaded_mainloop_lock);
+    load(threaded_mainloop_stop);
+    load(threaded_mainloop_wait);
+    load(threaded_mainloop_start);
+    load(threaded_mainloop_unlock);
+    load(threaded_mainloop_signal);
+    load(threaded_mainloop_get_api);
     load(context_new);
+    load(context_unref);
+    load(context_disconnect);
+    load(context_subscribe);
+    load(context_set_subscribe_callback);
+    load(context_get_sink_input_info);
+    load(context_get_source_output_info);
     load(context_connect);
     load(context_set_state_callback);
     load(context_load_module);
@@ -41,6 +53,8 @@ bool Soundux::PulseApi::setup()
     load(context_unload_module);
     load(context_get_state);
     load(operation_get_state);
+    load(operation_unref);
+    load(operation_set_state_callback);
     return true;
 #else
     auto *libpulse = dlopen("libpulse.so", RTLD_LAZY);
@@ -57,10 +71,22 @@ bool Soundux::PulseApi::setup()
 
 #define stringify(what) #what
 #define load(name) loadFunc(libpulse, name, stringify(pa_##name))
-            load(mainloop_new);
-            load(mainloop_iterate);
-            load(mainloop_get_api);
+            load(threaded_mainloop_new);
+            load(threaded_mainloop_free);
+            load(threaded_mainloop_lock);
+            load(threaded_mainloop_stop);
+            load(threaded_mainloop_wait);
+            load(threaded_mainloop_start);
+            load(threaded_mainloop_unlock);
+            load(threaded_mainloop_signal);
+            load(threaded_mainloop_get_api);
             load(context_new);
+            load(context_unref);
+            load(context_disconnect);
+            load(context_subscribe);
+            load(context_set_subscribe_callback);
+            load(context_get_sink_input_info);
+            load(context_get_source_output_info);
             load(context_connect);
             load(context_set_state_callback);
             load(context_load_module);
@@ -79,6 +105,10 @@ bool Soundux::PulseApi::setup()
             load(context_unload_module);
             load(context_get_state);
             load(operation_get_state);
+            load(operation_unref);
+            load(operation_set_state_callback);
+    load(operation_unref);
+    load(operation_set_state_callback);
             return true;
         }
         catch (std::exception &e)
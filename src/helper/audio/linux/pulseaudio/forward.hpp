@@ -14,13 +14,27 @@ namespace Soundux
 #define pulse_forward_decl(function) inline std::add_pointer_t<decltype(pa_##function)> function
 
         pulse_forward_decl(context_new);
-        pulse_forward_decl(mainloop_new);
+        pulse_forward_decl(context_unref);
         pulse_forward_decl(proplist_gets);
+        pulse_forward_decl(operation_unref);
         pulse_forward_decl(context_connect);
-        pulse_forward_decl(mainloop_iterate);
-        pulse_forward_decl(mainloop_get_api);
+        pulse_forward_decl(context_subscribe);
         pulse_forward_decl(context_get_state);
+        pulse_forward_decl(context_disconnect);
         pulse_forward_decl(operation_get_state);
+        pulse_forward_decl(threaded_mainloop_new);
+        pulse_forward_decl(threaded_mainloop_free);
+        pulse_forward_decl(threaded_mainloop_lock);
+        pulse_forward_decl(threaded_mainloop_stop);
+        pulse_forward_decl(threaded_mainloop_wait);
+        pulse_forward_decl(threaded_mainloop_start);
+        pulse_forward_decl(threaded_mainloop_unlock);
+        pulse_forward_decl(threaded_mainloop_signal);
+        pulse_forward_decl(threaded_mainloop_get_api);
+        pulse_forward_decl(operation_set_state_callback);
+        pulse_forward_decl(context_get_sink_input_info);
+        pulse_forward_decl(context_set_subscribe_callback);
+        pulse_forward_decl(context_get_source_output_info);
         pulse_forward_decl(context_load_module);
         pulse_forward_decl(context_unload_module);
         pulse_forward_decl(context_get_server_info);
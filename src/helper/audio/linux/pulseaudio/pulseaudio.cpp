@@ -1,13 +1,21 @@
 #if defined(__linux__)
 #include "pulseaudio.hpp"
 #include "forward.hpp"
+#include <algorithm>
+#include <chrono>
 #include <core/global/globals.hpp>
 #include <cstring>
 #include <exception>
 #include <fancy.hpp>
+#include <helper/metrics/metrics.hpp>
 
 namespace Soundux::Objects
 {
+    static auto elapsedMs(const std::chrono::steady_clock::time_point &start)
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
     bool PulseAudio::setup()
     {
         if (!PulseApi::setup())
@@ -15,50 +23,76 @@ namespace Soundux::Objects
             return false;
         }
 
-        mainloop = PulseApi::mainloop_new();
-        mainloopApi = PulseApi::mainloop_get_api(mainloop);
+        auto start = std::chrono::steady_clock::now();
+
+        mainloop = PulseApi::threaded_mainloop_new();
+        mainloopApi = PulseApi::threaded_mainloop_get_api(mainloop);
         context = PulseApi::context_new(mainloopApi, "soundux");
-        PulseApi::context_connect(context, nullptr, pa_context_flags::PA_CONTEXT_NOFLAGS, nullptr);
 
-        auto data = std::make_pair(false, false);
         PulseApi::context_set_state_callback(
             context,
-            [](pa_context *context, void *userData) {
-                auto state = PulseApi::context_get_state(context);
-                auto *data = reinterpret_cast<std::pair<bool, bool> *>(userData);
-
-                if (!data)
-                {
-                    return;
-                }
-
-                if (state == PA_CONTEXT_FAILED)
-                {
-                    Fancy::fancy.logTime().failure() << "Failed to connect to pulseaudio" << std::endl;
-                    data->first = true;
-                    data->second = false;
-                }
-                else if (state == PA_CONTEXT_READY)
-                {
-                    Fancy::fancy.logTime().message() << "PulseAudio is ready!" << std::endl;
-                    data->first = true;
-                    data->second = true;
-                }
+            []([[maybe_unused]] pa_context *context, void *userData) {
+                PulseApi::threaded_mainloop_signal(reinterpret_cast<pa_threaded_mainloop *>(userData), 0);
             },
-            &data);
+            mainloop);
+        PulseApi::context_set_subscribe_callback(context, onSubscriptionEvent, this);
+        PulseApi::context_connect(context, nullptr, pa_context_flags::PA_CONTEXT_NOFLAGS, nullptr);
 
-        while (!data.first)
+        if (PulseApi::threaded_mainloop_start(mainloop) < 0)
         {
-            PulseApi::mainloop_iterate(mainloop, true, nullptr);
+            Fancy::fancy.logTime().failure() << "Failed to start pulseaudio mainloop" << std::endl;
+            return false;
         }
 
-        if (!data.second)
+        PulseApi::threaded_mainloop_lock(mainloop);
+        auto state = PulseApi::context_get_state(context);
+        while (state != PA_CONTEXT_READY && state != PA_CONTEXT_FAILED && state != PA_CONTEXT_TERMINATED)
         {
+            PulseApi::threaded_mainloop_wait(mainloop);
+            state = PulseApi::context_get_state(context);
+        }
+        PulseApi::threaded_mainloop_unlock(mainloop);
+
+        if (state != PA_CONTEXT_READY)
+        {
+            Fancy::fancy.logTime().failure() << "Failed to connect to pulseaudio" << std::endl;
             return false;
         }
 
+        Fancy::fancy.logTime().message() << "PulseAudio is ready! (Connected in " << elapsedMs(start) << "ms)"
+                                         << std::endl;
+
         unloadLeftOvers();
-        fetchDefaultSource();
+
+        start = std::chrono::steady_clock::now();
+
+        //* We subscribe before listing, so that no app can slip through in between
+        await({
+            [&] {
+                return PulseApi::context_subscribe(
+                    context,
+                    static_cast<pa_subscription_mask_t>(PA_SUBSCRIPTION_MASK_SINK_INPUT |
+                                                        PA_SUBSCRIPTION_MASK_SOURCE_OUTPUT),
+                    nullptr, nullptr);
+            },
+            [&] { return PulseApi::context_get_sink_input_info_list(context, onSinkInputInfo, this); },
+            [&] { return PulseApi::context_get_source_output_info_list(context, onSourceOutputInfo, this); },
+            [&] {
+                return PulseApi::context_get_server_info(
+                    context,
+                    []([[maybe_unused]] pa_context *context, const pa_server_info *info, void *userData) {
+                        if (info)
+                        {
+                            reinterpret_cast<PulseAudio *>(userData)->defaultSource = info->default_source_name;
+                            reinterpret_cast<PulseAudio *>(userData)->serverName = info->server_name;
+                        }
+                    },
+                    this);
+            },
+        });
+
+        Fancy::fancy.logTime().message() << "Fetched server info and applications in " << elapsedMs(start) << "ms"
+                                         << std::endl;
 
         return !(defaultSource.empty() || serverName.empty() || isRunningPipeWire());
     }
@@ -67,83 +101,98 @@ namespace Soundux::Objects
         auto playbackApps = getPlaybackApps();
         auto recordingApps = getRecordingApps();
 
-        await(PulseApi::context_load_module(
-            context, "module-null-sink",
-            "sink_name=soundux_sink rate=44100 sink_properties=device.description=soundux_sink",
-            []([[maybe_unused]] pa_context *m, std::uint32_t id, void *userData) {
-                if (static_cast<int>(id) < 0)
-                {
-                    Fancy::fancy.logTime().failure() << "Failed to load null sink" << std::endl;
-                }
-                else
-                {
-                    *reinterpret_cast<std::optional<std::uint32_t> *>(userData) = id;
-                }
+        auto start = std::chrono::steady_clock::now();
+
+        //* The server handles requests in order, so the loopbacks only see the sinks once they exist
+        await({
+            [&] {
+                return PulseApi::context_load_module(
+                    context, "module-null-sink",
+                    "sink_name=soundux_sink rate=44100 sink_properties=device.description=soundux_sink",
+                    []([[maybe_unused]] pa_context *m, std::uint32_t id, void *userData) {
+                        if (static_cast<int>(id) < 0)
+                        {
+                            Fancy::fancy.logTime().failure() << "Failed to load null sink" << std::endl;
+                        }
+                        else
+                        {
+                            *reinterpret_cast<std::optional<std::uint32_t> *>(userData) = id;
+                        }
+                    },
+                    &nullSink);
             },
-            &nullSink));
-
-        await(PulseApi::context_load_module(
-            context, "module-loopback",
-            ("rate=44100 source=" + defaultSource + " sink=soundux_sink sink_dont_move=true source_dont_move=true")
-                .c_str(),
-            []([[maybe_unused]] pa_context *m, std::uint32_t id, void *userData) {
-                if (static_cast<int>(id) < 0)
-                {
-                    Fancy::fancy.logTime().failure() << "Failed to load loopback" << std::endl;
-                }
-                else
-                {
-                    *reinterpret_cast<std::optional<std::uint32_t> *>(userData) = id;
-                }
+            [&] {
+                return PulseApi::context_load_module(
+                    context, "module-loopback",
+                    ("rate=44100 source=" + defaultSource +
+                     " sink=soundux_sink sink_dont_move=true source_dont_move=true")
+                        .c_str(),
+                    []([[maybe_unused]] pa_context *m, std::uint32_t id, void *userData) {
+                        if (static_cast<int>(id) < 0)
+                        {
+                            Fancy::fancy.logTime().failure() << "Failed to load loopback" << std::endl;
+                        }
+                        else
+                        {
+                            *reinterpret_cast<std::optional<std::uint32_t> *>(userData) = id;
+                        }
+                    },
+                    &loopBack);
             },
-            &loopBack));
-
-        await(PulseApi::context_load_module(
-            context, "module-null-sink",
-            "sink_name=soundux_sink_passthrough rate=44100 sink_properties=device.description=soundux_sink_passthrough",
-            []([[maybe_unused]] pa_context *m, std::uint32_t id, void *userData) {
-                if (static_cast<int>(id) < 0)
-                {
-                    Fancy::fancy.logTime().failure() << "Failed to load passthrough null sink" << std::endl;
-                }
-                else
-                {
-                    *reinterpret_cast<std::optional<std::uint32_t> *>(userData) = id;
-                }
+            [&] {
+                return PulseApi::context_load_module(
+                    context, "module-null-sink",
+                    "sink_name=soundux_sink_passthrough rate=44100 "
+                    "sink_properties=device.description=soundux_sink_passthrough",
+                    []([[maybe_unused]] pa_context *m, std::uint32_t id, void *userData) {
+                        if (static_cast<int>(id) < 0)
+                        {
+                            Fancy::fancy.logTime().failure() << "Failed to load passthrough null sink" << std::endl;
+                        }
+                        else
+                        {
+                            *reinterpret_cast<std::optional<std::uint32_t> *>(userData) = id;
+                        }
+                    },
+                    &passthrough);
             },
-            &passthrough));
-
-        await(PulseApi::context_load_module(
-            context, "module-loopback",
-            "source=soundux_sink_passthrough.monitor sink=soundux_sink source_dont_move=true",
-            []([[maybe_unused]] pa_context *m, std::uint32_t id, void *userData) {
-                if (static_cast<int>(id) < 0)
-                {
-                    Fancy::fancy.logTime().failure() << "Failed to load passthrough sink" << std::endl;
-                }
-                else
-                {
-                    *reinterpret_cast<std::optional<std::uint32_t> *>(userData) = id;
-                }
+            [&] {
+                return PulseApi::context_load_module(
+                    context, "module-loopback",
+                    "source=soundux_sink_passthrough.monitor sink=soundux_sink source_dont_move=true",
+                    []([[maybe_unused]] pa_context *m, std::uint32_t id, void *userData) {
+                        if (static_cast<int>(id) < 0)
+                        {
+                            Fancy::fancy.logTime().failure() << "Failed to load passthrough sink" << std::endl;
+                        }
+                        else
+                        {
+                            *reinterpret_cast<std::optional<std::uint32_t> *>(userData) = id;
+                        }
+                    },
+                    &passthroughSink);
             },
-            &passthroughSink));
-
-        await(PulseApi::context_load_module(
-            context, "module-loopback", "source=soundux_sink_passthrough.monitor source_dont_move=true",
-            []([[maybe_unused]] pa_context *m, std::uint32_t id, void *userData) {
-                if (static_cast<int>(id) < 0)
-                {
-                    Fancy::fancy.logTime().failure() << "Failed to load passthrough loopback" << std::endl;
-                }
-                else
-                {
-                    *reinterpret_cast<std::optional<std::uint32_t> *>(userData) = id;
-                }
+            [&] {
+                return PulseApi::context_load_module(
+                    context, "module-loopback", "source=soundux_sink_passthrough.monitor source_dont_move=true",
+                    []([[maybe_unused]] pa_context *m, std::uint32_t id, void *userData) {
+                        if (static_cast<int>(id) < 0)
+                        {
+                            Fancy::fancy.logTime().failure() << "Failed to load passthrough loopback" << std::endl;
+                        }
+                        else
+                        {
+                            *reinterpret_cast<std::optional<std::uint32_t> *>(userData) = id;
+                        }
+                    },
+                    &passthroughLoopBack);
             },
-            &passthroughLoopBack));
+        });
 
         fetchLoopBackSinkId();
 
+        Fancy::fancy.logTime().message() << "Loaded modules in " << elapsedMs(start) << "ms" << std::endl;
+
         if (!nullSink || !loopBack || !loopBackSink || !passthrough || !passthroughSink || !passthroughLoopBack)
         {
             unloadLeftOvers();
@@ -161,122 +210,235 @@ namespace Soundux::Objects
         stopSoundInput();
         stopAllPassthrough();
 
-        if (nullSink)
-            await(PulseApi::context_unload_module(context, *nullSink, nullptr, nullptr));
-        if (loopBack)
-            await(PulseApi::context_unload_module(context, *loopBack, nullptr, nullptr));
-        if (loopBackSink)
-            await(PulseApi::context_unload_module(context, *loopBackSink, nullptr, nullptr));
+        std::vector<std::function<pa_operation *()>> operations;
+        for (const auto &module :
+             {nullSink, loopBack, loopBackSink, passthrough, passthroughSink, passthroughLoopBack})
+        {
+            if (module)
+            {
+                operations.emplace_back(
+                    [this, id = *module] { return PulseApi::context_unload_module(context, id, nullptr, nullptr); });
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        await(operations);
+
+        Fancy::fancy.logTime().message() << "Unloaded modules in " << elapsedMs(start) << "ms" << std::endl;
 
-        if (passthrough)
-            await(PulseApi::context_unload_module(context, *passthrough, nullptr, nullptr));
-        if (passthroughSink)
-            await(PulseApi::context_unload_module(context, *passthroughSink, nullptr, nullptr));
-        if (passthroughLoopBack)
-            await(PulseApi::context_unload_module(context, *passthroughLoopBack, nullptr, nullptr));
+        PulseApi::threaded_mainloop_stop(mainloop);
+        PulseApi::context_disconnect(context);
+        PulseApi::context_unref(context);
+        PulseApi::threaded_mainloop_free(mainloop);
     }
-    void PulseAudio::await(pa_operation *operation)
+    void PulseAudio::await(const std::vector<std::function<pa_operation *()>> &operations)
     {
-        std::lock_guard lock(operationMutex);
-        while (PulseApi::operation_get_state(operation) != PA_OPERATION_DONE)
+        PulseApi::threaded_mainloop_lock(mainloop);
+
+        std::vector<pa_operation *> pending;
+        for (const auto &operation : operations)
         {
-            PulseApi::mainloop_iterate(mainloop, true, nullptr);
+            if (auto *issued = operation(); issued)
+            {
+                PulseApi::operation_set_state_callback(
+                    issued,
+                    []([[maybe_unused]] pa_operation *operation, void *userData) {
+                        PulseApi::threaded_mainloop_signal(reinterpret_cast<pa_threaded_mainloop *>(userData), 0);
+                    },
+                    mainloop);
+                pending.emplace_back(issued);
+            }
         }
+
+        for (auto *operation : pending)
+        {
+            while (PulseApi::operation_get_state(operation) == PA_OPERATION_RUNNING)
+            {
+                PulseApi::threaded_mainloop_wait(mainloop);
+            }
+            PulseApi::operation_unref(operation);
+        }
+
+        PulseApi::threaded_mainloop_unlock(mainloop);
     }
-    void PulseAudio::fetchDefaultSource()
+    void PulseAudio::onSinkInputInfo([[maybe_unused]] pa_context *ctx, const pa_sink_input_info *info,
+                                     [[maybe_unused]] int eol, void *userData)
     {
-        await(PulseApi::context_get_server_info(
-            context,
-            []([[maybe_unused]] pa_context *context, const pa_server_info *info, void *userData) {
-                if (info)
-                {
-                    reinterpret_cast<PulseAudio *>(userData)->defaultSource = info->default_source_name;
-                    reinterpret_cast<PulseAudio *>(userData)->serverName = info->server_name;
-                }
-            },
-            this));
+        auto *thiz = reinterpret_cast<PulseAudio *>(userData);
+        if (!info || !thiz)
+        {
+            return;
+        }
+
+        if (info->driver && std::strcmp(info->driver, "protocol-native.c") == 0)
+        {
+            PulsePlaybackApp app;
+
+            app.id = info->index;
+            app.sink = info->sink;
+            app.application = PulseApi::proplist_gets(info->proplist, "application.name");
+            app.name = PulseApi::proplist_gets(info->proplist, "application.process.binary");
+            app.pid = std::stoi(PulseApi::proplist_gets(info->proplist, "application.process.id"));
+
+            thiz->playbackApps->insert_or_assign(info->index, app);
+        }
+        else
+        {
+            thiz->playbackApps->erase(info->index);
+        }
+    }
+    void PulseAudio::onSourceOutputInfo([[maybe_unused]] pa_context *ctx, const pa_source_output_info *info,
+                                        [[maybe_unused]] int eol, void *userData)
+    {
+        auto *thiz = reinterpret_cast<PulseAudio *>(userData);
+        if (!info || !thiz)
+        {
+            return;
+        }
+
+        if (info->driver && std::strcmp(info->driver, "protocol-native.c") == 0 &&
+            !(info->resample_method && std::strcmp(info->resample_method, "peaks") == 0))
+        {
+            PulseRecordingApp app;
+
+            app.id = info->index;
+            app.source = info->source;
+            app.application = PulseApi::proplist_gets(info->proplist, "application.name");
+            app.name = PulseApi::proplist_gets(info->proplist, "application.process.binary");
+            app.pid = std::stoi(PulseApi::proplist_gets(info->proplist, "application.process.id"));
+
+            thiz->recordingApps->insert_or_assign(info->index, app);
+        }
+        else
+        {
+            thiz->recordingApps->erase(info->index);
+        }
+    }
+    void PulseAudio::onSubscriptionEvent(pa_context *ctx, pa_subscription_event_type_t event, std::uint32_t index,
+                                         void *userData)
+    {
+        auto *thiz = reinterpret_cast<PulseAudio *>(userData);
+        if (!thiz)
+        {
+            return;
+        }
+
+        auto facility = event & PA_SUBSCRIPTION_EVENT_FACILITY_MASK;
+        auto type = event & PA_SUBSCRIPTION_EVENT_TYPE_MASK;
+
+        //* We're on the mainloop thread here, so we only issue the request and let the callback update the cache
+        if (facility == PA_SUBSCRIPTION_EVENT_SINK_INPUT)
+        {
+            if (type == PA_SUBSCRIPTION_EVENT_REMOVE)
+            {
+                thiz->playbackApps->erase(index);
+            }
+            else if (auto *operation = PulseApi::context_get_sink_input_info(ctx, index, onSinkInputInfo, thiz);
+                     operation)
+            {
+                PulseApi::operation_unref(operation);
+            }
+        }
+        else if (facility == PA_SUBSCRIPTION_EVENT_SOURCE_OUTPUT)
+        {
+            if (type == PA_SUBSCRIPTION_EVENT_REMOVE)
+            {
+                thiz->recordingApps->erase(index);
+            }
+            else if (auto *operation =
+                         PulseApi::context_get_source_output_info(ctx, index, onSourceOutputInfo, thiz);
+                     operation)
+            {
+                PulseApi::operation_unref(operation);
+            }
+        }
     }
     void PulseAudio::fetchLoopBackSinkId()
     {
         auto data = std::make_pair(&loopBackSink, loopBack);
 
-        await(PulseApi::context_get_sink_input_info_list(
-            context,
-            []([[maybe_unused]] pa_context *ctx, const pa_sink_input_info *info, [[maybe_unused]] int eol,
-               void *userData) {
-                auto pair = *reinterpret_cast<decltype(data) *>(userData);
-                if (info && info->owner_module && info->owner_module == pair.second)
-                {
-                    *pair.first = info->index;
-                }
-            },
-            &data));
+        await({[&] {
+            return PulseApi::context_get_sink_input_info_list(
+                context,
+                []([[maybe_unused]] pa_context *ctx, const pa_sink_input_info *info, [[maybe_unused]] int eol,
+                   void *userData) {
+                    auto pair = *reinterpret_cast<decltype(data) *>(userData);
+                    if (info && info->owner_module && info->owner_module == pair.second)
+                    {
+                        *pair.first = info->index;
+                    }
+                },
+                &data);
+        }});
     }
     void PulseAudio::unloadLeftOvers()
     {
-        await(PulseApi::context_get_module_info_list(
-            context,
-            []([[maybe_unused]] pa_context *ctx, const pa_module_info *info, [[maybe_unused]] int eol, void *userData) {
-                if (info && info->argument)
-                {
-                    if (std::string(info->argument).find("soundux") != std::string::npos)
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::uint32_t> leftOvers;
+
+        await({[&] {
+            return PulseApi::context_get_module_info_list(
+                context,
+                []([[maybe_unused]] pa_context *ctx, const pa_module_info *info, [[maybe_unused]] int eol,
+                   void *userData) {
+                    if (info && info->argument)
                     {
-                        auto *thiz = reinterpret_cast<PulseAudio *>(userData);
-                        PulseApi::context_unload_module(thiz->context, info->index, nullptr, nullptr);
-                        Fancy::fancy.logTime().success() << "Unloaded left over module " << info->index << std::endl;
+                        if (std::string(info->argument).find("soundux") != std::string::npos)
+                        {
+                            reinterpret_cast<std::vector<std::uint32_t> *>(userData)->emplace_back(info->index);
+                        }
                     }
-                }
-            },
-            this));
+                },
+                &leftOvers);
+        }});
+
+        std::vector<std::function<pa_operation *()>> operations;
+        for (auto &id : leftOvers)
+        {
+            operations.emplace_back([this, &id] {
+                return PulseApi::context_unload_module(
+                    context, id,
+                    []([[maybe_unused]] pa_context *ctx, int success, void *userData) {
+                        if (success)
+                        {
+                            Fancy::fancy.logTime().success()
+                                << "Unloaded left over module " << *reinterpret_cast<std::uint32_t *>(userData)
+                                << std::endl;
+                        }
+                    },
+                    &id);
+            });
+        }
+        await(operations);
+
+        Fancy::fancy.logTime().message() << "Unloaded " << leftOvers.size() << " left over module(s) in "
+                                         << elapsedMs(start) << "ms" << std::endl;
     }
     std::vector<std::shared_ptr<PlaybackApp>> PulseAudio::getPlaybackApps()
     {
+        TraceScope scope("getPlaybackApps");
+
         std::vector<std::shared_ptr<PlaybackApp>> rtn;
-        await(PulseApi::context_get_sink_input_info_list(
-            context,
-            []([[maybe_unused]] pa_context *ctx, const pa_sink_input_info *info, [[maybe_unused]] int eol,
-               void *userData) {
-                if (info && info->driver && std::strcmp(info->driver, "protocol-native.c") == 0)
-                {
-                    PulsePlaybackApp app;
-
-                    app.id = info->index;
-                    app.sink = info->sink;
-                    app.application = PulseApi::proplist_gets(info->proplist, "application.name");
-                    app.name = PulseApi::proplist_gets(info->proplist, "application.process.binary");
-                    app.pid = std::stoi(PulseApi::proplist_gets(info->proplist, "application.process.id"));
-                    reinterpret_cast<decltype(rtn) *>(userData)->emplace_back(std::make_shared<PulsePlaybackApp>(app));
-                }
-            },
-            &rtn));
+
+        auto scoped = playbackApps.scoped();
+        for (const auto &[id, app] : *scoped)
+        {
+            rtn.emplace_back(std::make_shared<PulsePlaybackApp>(app));
+        }
 
         return rtn;
     }
     std::vector<std::shared_ptr<RecordingApp>> PulseAudio::getRecordingApps()
     {
-        std::vector<std::shared_ptr<RecordingApp>> rtn;
-        await(PulseApi::context_get_source_output_info_list(
-            context,
-            []([[maybe_unused]] pa_context *ctx, const pa_source_output_info *info, [[maybe_unused]] int eol,
-               void *userData) {
-                if (info && info->driver && std::strcmp(info->driver, "protocol-native.c") == 0)
-                {
-                    if (info->resample_method && std::strcmp(info->resample_method, "peaks") == 0)
-                    {
-                        return;
-                    }
+        TraceScope scope("getRecordingApps");
 
-                    PulseRecordingApp app;
+        std::vector<std::shared_ptr<RecordingApp>> rtn;
 
-                    app.id = info->index;
-                    app.source = info->source;
-                    app.application = PulseApi::proplist_gets(info->proplist, "application.name");
-                    app.name = PulseApi::proplist_gets(info->proplist, "application.process.binary");
-                    app.pid = std::stoi(PulseApi::proplist_gets(info->proplist, "application.process.id"));
-                    reinterpret_cast<decltype(rtn) *>(userData)->emplace_back(std::make_shared<PulseRecordingApp>(app));
-                }
-            },
-            &rtn));
+        auto scoped = recordingApps.scoped();
+        for (const auto &[id, app] : *scoped)
+        {
+            rtn.emplace_back(std::make_shared<PulseRecordingApp>(app));
+        }
 
         return rtn;
     }
@@ -284,22 +446,24 @@ namespace Soundux::Objects
     {
         if (!defaultSource.empty())
         {
-            await(PulseApi::context_unload_module(context, *loopBack, nullptr, nullptr));
+            await({[&] { return PulseApi::context_unload_module(context, *loopBack, nullptr, nullptr); }});
 
-            await(PulseApi::context_load_module(
-                context, "module-loopback", ("rate=44100 source=" + defaultSource + " sink=soundux_sink").c_str(),
-                []([[maybe_unused]] pa_context *m, std::uint32_t id, void *userData) {
-                    if (static_cast<int>(id) < 0)
-                    {
-                        Fancy::fancy.logTime().failure() << "Failed to load loopback" << std::endl;
-                        *reinterpret_cast<std::optional<std::uint32_t> *>(userData) = std::nullopt;
-                    }
-                    else
-                    {
-                        *reinterpret_cast<std::optional<std::uint32_t> *>(userData) = id;
-                    }
-                },
-                &loopBack));
+            await({[&] {
+                return PulseApi::context_load_module(
+                    context, "module-loopback", ("rate=44100 source=" + defaultSource + " sink=soundux_sink").c_str(),
+                    []([[maybe_unused]] pa_context *m, std::uint32_t id, void *userData) {
+                        if (static_cast<int>(id) < 0)
+                        {
+                            Fancy::fancy.logTime().failure() << "Failed to load loopback" << std::endl;
+                            *reinterpret_cast<std::optional<std::uint32_t> *>(userData) = std::nullopt;
+                        }
+                        else
+                        {
+                            *reinterpret_cast<std::optional<std::uint32_t> *>(userData) = id;
+                        }
+                    },
+                    &loopBack);
+            }});
 
             if (!loopBack)
             {
@@ -307,12 +471,14 @@ namespace Soundux::Objects
             }
 
             bool success = false;
-            await(PulseApi::context_set_default_source(
-                context, "soundux_sink.monitor",
-                []([[maybe_unused]] pa_context *ctx, int success, void *userData) {
-                    *reinterpret_cast<bool *>(userData) = success;
-                },
-                &success));
+            await({[&] {
+                return PulseApi::context_set_default_source(
+                    context, "soundux_sink.monitor",
+                    []([[maybe_unused]] pa_context *ctx, int success, void *userData) {
+                        *reinterpret_cast<bool *>(userData) = success;
+                    },
+                    &success);
+            }});
 
             if (!success)
             {
@@ -330,20 +496,23 @@ namespace Soundux::Objects
     {
         if (!defaultSource.empty() && loopBack)
         {
-            await(PulseApi::context_unload_module(context, *loopBack, nullptr, nullptr));
+            await({[&] { return PulseApi::context_unload_module(context, *loopBack, nullptr, nullptr); }});
 
             auto result = std::make_pair(&loopBack, false);
 
-            await(PulseApi::context_load_module(
-                context, "module-loopback",
-                ("rate=44100 source=" + defaultSource + " sink=soundux_sink sink_dont_move=true source_dont_move=true")
-                    .c_str(),
-                []([[maybe_unused]] pa_context *m, std::uint32_t id, void *userData) {
-                    auto *pair = reinterpret_cast<decltype(result) *>(userData);
-                    *(pair->first) = id;
-                    pair->second = id > 0;
-                },
-                &result));
+            await({[&] {
+                return PulseApi::context_load_module(
+                    context, "module-loopback",
+                    ("rate=44100 source=" + defaultSource +
+                     " sink=soundux_sink sink_dont_move=true source_dont_move=true")
+                        .c_str(),
+                    []([[maybe_unused]] pa_context *m, std::uint32_t id, void *userData) {
+                        auto *pair = reinterpret_cast<decltype(result) *>(userData);
+                        *(pair->first) = id;
+                        pair->second = id > 0;
+                    },
+                    &result);
+            }});
 
             if (!result.second)
             {
@@ -352,12 +521,14 @@ namespace Soundux::Objects
             }
 
             bool success = false;
-            await(PulseApi::context_set_default_source(
-                context, defaultSource.c_str(),
-                []([[maybe_unused]] pa_context *ctx, int success, void *userData) {
-                    *reinterpret_cast<bool *>(userData) = success;
-                },
-                &success));
+            await({[&] {
+                return PulseApi::context_set_default_source(
+                    context, defaultSource.c_str(),
+                    []([[maybe_unused]] pa_context *ctx, int success, void *userData) {
+                        *reinterpret_cast<bool *>(userData) = success;
+                    },
+                    &success);
+            }});
 
             if (!success)
             {
@@ -370,6 +541,8 @@ namespace Soundux::Objects
     }
     bool PulseAudio::passthroughFrom(std::shared_ptr<PlaybackApp> app)
     {
+        TraceScope scope("passthroughFrom");
+
         if (movedPassthroughApplications.count(app->name))
         {
             Fancy::fancy.logTime().message()
@@ -383,31 +556,35 @@ namespace Soundux::Objects
             return false;
         }
 
+        bool success = true;
+        std::vector<std::function<pa_operation *()>> operations;
+
         for (const auto &playbackApp : getPlaybackApps())
         {
             auto pulsePlayback = std::dynamic_pointer_cast<PulsePlaybackApp>(playbackApp);
 
             if (playbackApp->name == app->name)
             {
-                bool success = true;
+                operations.emplace_back([this, id = pulsePlayback->id, &success] {
+                    return PulseApi::context_move_sink_input_by_name(
+                        context, id, "soundux_sink_passthrough",
+                        []([[maybe_unused]] pa_context *ctx, int success, void *userData) {
+                            if (!success)
+                            {
+                                *reinterpret_cast<bool *>(userData) = false;
+                            }
+                        },
+                        &success);
+                });
+            }
+        }
 
-                await(PulseApi::context_move_sink_input_by_name(
-                    context, pulsePlayback->id, "soundux_sink_passthrough",
-                    []([[maybe_unused]] pa_context *ctx, int success, void *userData) {
-                        if (!success)
-                        {
-                            *reinterpret_cast<bool *>(userData) = false;
-                        }
-                    },
-                    &success));
+        await(operations);
 
-                if (!success)
-                {
-                    Fancy::fancy.logTime().warning()
-                        << "Failed top move " << pulsePlayback->id << " to passthrough" << std::endl;
-                    return false;
-                }
-            }
+        if (!success)
+        {
+            Fancy::fancy.logTime().warning() << "Failed to move " << app->name << " to passthrough" << std::endl;
+            return false;
         }
 
         movedPassthroughApplications.emplace(app->name, std::dynamic_pointer_cast<PulsePlaybackApp>(app)->sink);
@@ -415,27 +592,32 @@ namespace Soundux::Objects
     }
     bool PulseAudio::stopAllPassthrough()
     {
+        TraceScope scope("stopAllPassthrough");
+
         bool success = true;
-        for (const auto &[movedAppName, originalSource] : movedPassthroughApplications)
+        std::vector<std::function<pa_operation *()>> operations;
+
+        for (const auto &app : getPlaybackApps())
         {
-            for (const auto &app : getPlaybackApps())
-            {
-                auto pulseApp = std::dynamic_pointer_cast<PulsePlaybackApp>(app);
+            auto pulseApp = std::dynamic_pointer_cast<PulsePlaybackApp>(app);
 
-                if (app->name == movedAppName)
-                {
-                    await(PulseApi::context_move_sink_input_by_index(
-                        context, pulseApp->id, originalSource,
+            if (auto moved = movedPassthroughApplications.find(app->name); moved != movedPassthroughApplications.end())
+            {
+                operations.emplace_back([this, id = pulseApp->id, originalSink = moved->second, &success] {
+                    return PulseApi::context_move_sink_input_by_index(
+                        context, id, originalSink,
                         []([[maybe_unused]] pa_context *ctx, int success, void *userData) {
                             if (!success)
                             {
                                 *reinterpret_cast<bool *>(userData) = false;
                             }
                         },
-                        &success));
-                }
+                        &success);
+                });
             }
         }
+
+        await(operations);
         movedPassthroughApplications.clear();
 
         if (!success)
@@ -447,28 +629,36 @@ namespace Soundux::Objects
     }
     bool PulseAudio::stopPassthrough(const std::string &name)
     {
+        TraceScope scope("stopPassthrough");
+
         if (movedPassthroughApplications.find(name) != movedPassthroughApplications.end())
         {
             bool success = true;
             auto &originalSource = movedPassthroughApplications.at(name);
+            std::vector<std::function<pa_operation *()>> operations;
+
             for (const auto &playbackApp : getPlaybackApps())
             {
                 auto pulseApp = std::dynamic_pointer_cast<PulsePlaybackApp>(playbackApp);
 
                 if (playbackApp->name == name)
                 {
-                    await(PulseApi::context_move_sink_input_by_index(
-                        context, pulseApp->id, originalSource,
-                        []([[maybe_unused]] pa_context *ctx, int success, void *userData) {
-                            if (!success)
-                            {
-                                *reinterpret_cast<bool *>(userData) = false;
-                            }
-                        },
-                        &success));
+                    operations.emplace_back([this, id = pulseApp->id, &originalSource, &success] {
+                        return PulseApi::context_move_sink_input_by_index(
+                            context, id, originalSource,
+                            []([[maybe_unused]] pa_context *ctx, int success, void *userData) {
+                                if (!success)
+                                {
+                                    *reinterpret_cast<bool *>(userData) = false;
+                                }
+                            },
+                            &success);
+                    });
                 }
             }
 
+            await(operations);
+
             movedPassthroughApplications.erase(name);
             if (!success)
             {
@@ -487,80 +677,163 @@ namespace Soundux::Objects
             return false;
         }
 
-        if (movedApplications.find(app->name) != movedApplications.end())
+        return inputSoundToAll({app}).count(app->name) > 0;
+    }
+    std::set<std::string> PulseAudio::inputSoundToAll(const std::vector<std::shared_ptr<RecordingApp>> &apps)
+    {
+        TraceScope scope("inputSoundToAll");
+
+        std::set<std::string> rtn;
+        std::map<std::string, std::shared_ptr<PulseRecordingApp>> pending;
+
+        for (const auto &app : apps)
         {
-            return true;
+            if (!app)
+            {
+                continue;
+            }
+
+            if (movedApplications.find(app->name) != movedApplications.end())
+            {
+                if (isSoundInputLive(app->name))
+                {
+                    rtn.emplace(app->name);
+                    continue;
+                }
+
+                //* The streams we moved are gone, the app has to be moved again
+                movedApplications.erase(app->name);
+                movedStreams.erase(app->name);
+            }
+
+            if (auto pulseApp = std::dynamic_pointer_cast<PulseRecordingApp>(app); pulseApp)
+            {
+                pending.emplace(app->name, pulseApp);
+            }
         }
 
+        if (pending.empty())
+        {
+            return rtn;
+        }
+
+        bool success = true;
+        std::map<std::string, std::vector<std::uint32_t>> streams;
+        std::vector<std::function<pa_operation *()>> operations;
+
         for (const auto &recordingApp : getRecordingApps())
         {
             auto pulseApp = std::dynamic_pointer_cast<PulseRecordingApp>(recordingApp);
 
-            if (pulseApp->name == app->name)
+            if (pending.count(pulseApp->name))
             {
-                bool success = true;
-                await(PulseApi::context_move_source_output_by_name(
-                    context, pulseApp->id, "soundux_sink.monitor",
-                    []([[maybe_unused]] pa_context *ctx, int success, void *userData) {
-                        if (!success)
-                        {
-                            *reinterpret_cast<bool *>(userData) = false;
-                        }
-                    },
-                    &success));
-
-                if (!success)
-                {
-                    Fancy::fancy.logTime().warning() << "Failed to move " + pulseApp->name << "(" << pulseApp->id
-                                                     << ") to soundux sink" << std::endl;
-                }
+                streams[pulseApp->name].emplace_back(pulseApp->id);
+                operations.emplace_back([this, id = pulseApp->id, &success] {
+                    return PulseApi::context_move_source_output_by_name(
+                        context, id, "soundux_sink.monitor",
+                        []([[maybe_unused]] pa_context *ctx, int success, void *userData) {
+                            if (!success)
+                            {
+                                *reinterpret_cast<bool *>(userData) = false;
+                            }
+                        },
+                        &success);
+                });
             }
         }
 
-        movedApplications.emplace(app->name, std::dynamic_pointer_cast<PulseRecordingApp>(app)->source);
-        return true;
+        //* The streams of all apps are moved in a single round trip
+        await(operations);
+
+        if (!success)
+        {
+            Fancy::fancy.logTime().warning() << "Failed to move one or more streams to soundux sink" << std::endl;
+        }
+
+        for (const auto &[name, app] : pending)
+        {
+            movedApplications.emplace(name, app->source);
+            movedStreams.insert_or_assign(name, streams[name]);
+            rtn.emplace(name);
+        }
+
+        return rtn;
+    }
+    bool PulseAudio::isSoundInputLive(const std::string &name)
+    {
+        auto moved = movedStreams.find(name);
+        if (moved == movedStreams.end())
+        {
+            return false;
+        }
+
+        auto scoped = recordingApps.scoped();
+        return std::any_of(moved->second.begin(), moved->second.end(),
+                           [&](const auto &id) { return scoped->find(id) != scoped->end(); });
     }
     bool PulseAudio::stopSoundInput()
     {
+        std::set<std::string> names;
+        for (const auto &[app, original] : movedApplications)
+        {
+            names.emplace(app);
+        }
+
+        return stopSoundInputFor(names);
+    }
+    bool PulseAudio::stopSoundInputFor(const std::set<std::string> &names)
+    {
+        TraceScope scope("stopSoundInputFor");
+
         bool success = true;
+        std::vector<std::function<pa_operation *()>> operations;
 
-        for (const auto &[movedAppName, originalSink] : movedApplications)
+        for (const auto &recordingApp : getRecordingApps())
         {
-            for (const auto &recordingApp : getRecordingApps())
+            auto pulseApp = std::dynamic_pointer_cast<PulseRecordingApp>(recordingApp);
+
+            if (auto moved = movedApplications.find(pulseApp->name);
+                moved != movedApplications.end() && names.count(pulseApp->name))
             {
-                auto pulseApp = std::dynamic_pointer_cast<PulseRecordingApp>(recordingApp);
-                if (pulseApp->name == movedAppName)
-                {
-                    await(PulseApi::context_move_source_output_by_index(
-                        context, pulseApp->id, originalSink,
+                operations.emplace_back([this, id = pulseApp->id, originalSource = moved->second, &success] {
+                    return PulseApi::context_move_source_output_by_index(
+                        context, id, originalSource,
                         []([[maybe_unused]] pa_context *ctx, int success, void *userData) {
                             if (!success)
                             {
                                 *reinterpret_cast<bool *>(userData) = false;
                             }
                         },
-                        &success));
-
-                    if (!success)
-                    {
-                        Fancy::fancy.logTime().warning() << "Failed to move " << pulseApp->name << "(" << pulseApp->id
-                                                         << ") back to original source" << std::endl;
-                        success = false;
-                    }
-                }
+                        &success);
+                });
             }
         }
-        movedApplications.clear();
+
+        await(operations);
+        for (const auto &name : names)
+        {
+            movedApplications.erase(name);
+            movedStreams.erase(name);
+        }
+
+        if (!success)
+        {
+            Fancy::fancy.logTime().warning() << "Failed to move one or more applications back to their original source"
+                                             << std::endl;
+        }
 
         return success;
     }
     std::shared_ptr<PlaybackApp> PulseAudio::getPlaybackApp(const std::string &name)
     {
-        for (auto app : getPlaybackApps())
+        TraceScope scope("getPlaybackApp");
+
+        auto scoped = playbackApps.scoped();
+        for (const auto &[id, app] : *scoped)
         {
-            if (app->name == name)
+            if (app.name == name)
             {
-                return app;
+                return std::make_shared<PulsePlaybackApp>(app);
             }
         }
 
@@ -568,11 +841,14 @@ namespace Soundux::Objects
     }
     std::shared_ptr<RecordingApp> PulseAudio::getRecordingApp(const std::string &name)
     {
-        for (auto app : getRecordingApps())
+        TraceScope scope("getRecordingApp");
+
+        auto scoped = recordingApps.scoped();
+        for (const auto &[id, app] : *scoped)
         {
-            if (app->name == name)
+            if (app.name == name)
             {
-                return app;
+                return std::make_shared<PulseRecordingApp>(app);
             }
         }
 
@@ -581,6 +857,8 @@ namespace Soundux::Objects
 
     void PulseAudio::fixPlaybackApps(const std::vector<std::shared_ptr<PlaybackApp>> &originalPlayback)
     {
+        std::vector<std::function<pa_operation *()>> operations;
+
         for (const auto &playbackApp : getPlaybackApps())
         {
             auto pulsePlaybackApp = std::dynamic_pointer_cast<PulsePlaybackApp>(playbackApp);
@@ -594,16 +872,21 @@ namespace Soundux::Objects
                 auto *pulseOriginal = dynamic_cast<PulsePlaybackApp *>(originalPlaybackApp->get());
                 if (pulseOriginal->sink != pulsePlaybackApp->sink)
                 {
-                    await(PulseApi::context_move_sink_input_by_index(context, pulsePlaybackApp->id, pulseOriginal->sink,
-                                                                     nullptr, nullptr));
+                    operations.emplace_back([this, id = pulsePlaybackApp->id, sink = pulseOriginal->sink] {
+                        return PulseApi::context_move_sink_input_by_index(context, id, sink, nullptr, nullptr);
+                    });
                     Fancy::fancy.logTime().success()
                         << "Recovered " << pulsePlaybackApp->id << " from soundux passthrough" << std::endl;
                 }
             }
         }
+
+        await(operations);
     }
     void PulseAudio::fixRecordingApps(const std::vector<std::shared_ptr<RecordingApp>> &originalRecording)
     {
+        std::vector<std::function<pa_operation *()>> operations;
+
         for (const auto &recordingApp : getRecordingApps())
         {
             auto pulseRecordingApp = std::dynamic_pointer_cast<PulseRecordingApp>(recordingApp);
@@ -617,24 +900,31 @@ namespace Soundux::Objects
                 auto *pulseOriginal = dynamic_cast<PulseRecordingApp *>(originalRecordingApp->get());
                 if (pulseOriginal->source != pulseRecordingApp->source)
                 {
-                    await(PulseApi::context_move_source_output_by_index(context, pulseRecordingApp->id,
-                                                                        pulseOriginal->source, nullptr, nullptr));
+                    operations.emplace_back([this, id = pulseRecordingApp->id, source = pulseOriginal->source] {
+                        return PulseApi::context_move_source_output_by_index(context, id, source, nullptr, nullptr);
+                    });
                     Fancy::fancy.logTime().success()
                         << "Recovered " << pulseRecordingApp->id << " from soundux sink" << std::endl;
                 }
             }
         }
+
+        await(operations);
     }
     bool PulseAudio::muteInput(bool state)
     {
+        TraceScope scope("muteInput");
+
         bool success = false;
 
-        await(PulseApi::context_set_sink_input_mute(
-            context, *loopBackSink, state,
-            +[]([[maybe_unused]] pa_context *ctx, int success, void *userData) {
-                *reinterpret_cast<bool *>(userData) = success;
-            },
-            &success));
+        await({[&] {
+            return PulseApi::context_set_sink_input_mute(
+                context, *loopBackSink, state,
+                +[]([[maybe_unused]] pa_context *ctx, int success, void *userData) {
+                    *reinterpret_cast<bool *>(userData) = success;
+                },
+                &success);
+        }});
 
         if (!success)
         {
@@ -647,19 +937,22 @@ namespace Soundux::Objects
     bool PulseAudio::switchOnConnectPresent()
     {
         bool isPresent = false;
-        await(PulseApi::context_get_module_info_list(
-            context,
-            []([[maybe_unused]] pa_context *ctx, const pa_module_info *info, [[maybe_unused]] int eol, void *userData) {
-                if (info && info->name)
-                {
-                    if (std::string(info->name).find("switch-on-connect") != std::string::npos)
+        await({[&] {
+            return PulseApi::context_get_module_info_list(
+                context,
+                []([[maybe_unused]] pa_context *ctx, const pa_module_info *info, [[maybe_unused]] int eol,
+                   void *userData) {
+                    if (info && info->name)
                     {
-                        *reinterpret_cast<bool *>(userData) = true;
-                        Fancy::fancy.logTime().warning() << "Switch on connect found: " << info->index << std::endl;
+                        if (std::string(info->name).find("switch-on-connect") != std::string::npos)
+                        {
+                            *reinterpret_cast<bool *>(userData) = true;
+                            Fancy::fancy.logTime().warning() << "Switch on connect found: " << info->index << std::endl;
+                        }
                     }
-                }
-            },
-            &isPresent));
+                },
+                &isPresent);
+        }});
 
         if (isPresent)
         {
@@ -674,25 +967,27 @@ namespace Soundux::Objects
 
     void PulseAudio::unloadSwitchOnConnect()
     {
-        await(PulseApi::context_get_module_info_list(
-            context,
-            []([[maybe_unused]] pa_context *ctx, const pa_module_info *info, [[maybe_unused]] int eol,
-               [[maybe_unused]] void *userData) {
-                if (info && info->name)
-                {
-                    if (std::string(info->name).find("switch-on-connect") != std::string::npos)
+        await({[&] {
+            return PulseApi::context_get_module_info_list(
+                context,
+                []([[maybe_unused]] pa_context *ctx, const pa_module_info *info, [[maybe_unused]] int eol,
+                   [[maybe_unused]] void *userData) {
+                    if (info && info->name)
                     {
-                        Fancy::fancy.logTime().message() << "Unloading: " << info->index << std::endl;
-                        PulseApi::context_unload_module(ctx, info->index, nullptr, nullptr);
-
-                        if (Globals::gGui)
+                        if (std::string(info->name).find("switch-on-connect") != std::string::npos)
                         {
-                            Globals::gGui->onSwitchOnConnectDetected(false);
+                            Fancy::fancy.logTime().message() << "Unloading: " << info->index << std::endl;
+                            PulseApi::context_unload_module(ctx, info->index, nullptr, nullptr);
+
+                            if (Globals::gGui)
+                            {
+                                Globals::gGui->onSwitchOnConnectDetected(false);
+                            }
                         }
                     }
-                }
-            },
-            nullptr));
+                },
+                nullptr);
+        }});
     }
     bool PulseAudio::isRunningPipeWire()
     {
@@ -728,4 +1023,4 @@ namespace Soundux::Objects
         return rtn;
     }
 } // namespace Soundux::Objects
-#endif
\ No newline at end of file
+#endif
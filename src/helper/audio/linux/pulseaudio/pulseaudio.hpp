@@ -1,9 +1,10 @@
 #if defined(__linux__)
 #include "../backend.hpp"
 #include "forward.hpp"
+#include <functional>
 #include <map>
-#include <mutex>
 #include <optional>
+#include <var_guard.hpp>
 
 namespace Soundux
 {
@@ -33,8 +34,8 @@ namespace Soundux
 
           private:
             pa_context *context;
-            pa_mainloop *mainloop;
             pa_mainloop_api *mainloopApi;
+            pa_threaded_mainloop *mainloop;
 
             //* ~= The modules we create =~
             std::optional<std::uint32_t> nullSink;
@@ -50,14 +51,23 @@ namespace Soundux
             std::string defaultSource;
 
             std::map<std::string, std::uint32_t> movedApplications;
+            //* Source output ids that were moved for each app, used to notice when an app re-created its streams
+            std::map<std::string, std::vector<std::uint32_t>> movedStreams;
             std::map<std::string, std::uint32_t> movedPassthroughApplications;
 
-            std::mutex operationMutex;
+            //* Kept up to date by the subscription, so that lookups don't need a round trip
+            sxl::var_guard<std::map<std::uint32_t, PulsePlaybackApp>> playbackApps;
+            sxl::var_guard<std::map<std::uint32_t, PulseRecordingApp>> recordingApps;
+
+            static void onSinkInputInfo(pa_context *, const pa_sink_input_info *, int, void *);
+            static void onSourceOutputInfo(pa_context *, const pa_source_output_info *, int, void *);
+            static void onSubscriptionEvent(pa_context *, pa_subscription_event_type_t, std::uint32_t, void *);
 
             void unloadLeftOvers();
-            void fetchDefaultSource();
             void fetchLoopBackSinkId();
-            void await(pa_operation *);
+
+            //* Issues all operations at once and waits until every one of them is done
+            void await(const std::vector<std::function<pa_operation *()>> &);
 
             void fixPlaybackApps(const std::vector<std::shared_ptr<PlaybackApp>> &);
             void fixRecordingApps(const std::vector<std::shared_ptr<RecordingApp>> &);
@@ -85,6 +95,9 @@ namespace Soundux
 
             bool stopSoundInput() override;
             bool inputSoundTo(std::shared_ptr<RecordingApp> app) override;
+            std::set<std::string> inputSoundToAll(const std::vector<std::shared_ptr<RecordingApp>> &apps) override;
+            bool stopSoundInputFor(const std::set<std::string> &names) override;
+            bool isSoundInputLive(const std::string &name) override;
 
             void unloadSwitchOnConnect();
             bool switchOnConnectPresent();
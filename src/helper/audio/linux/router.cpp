@@ -0,0 +1,183 @@
+#if defined(__linux__)
+#include "router.hpp"
+#include <core/global/globals.hpp>
+#include <fancy.hpp>
+
+namespace Soundux::Objects
+{
+    Router::Router()
+    {
+        handler = std::thread([this] { handle(); });
+    }
+    Router::~Router()
+    {
+        stop = true;
+        cv.notify_all();
+        handler.join();
+    }
+    void Router::handle()
+    {
+        std::unique_lock lock(mutex);
+        while (!stop)
+        {
+            if (!teardownAt)
+            {
+                cv.wait(lock, [&]() { return teardownAt || stop; });
+                continue;
+            }
+
+            cv.wait_until(lock, *teardownAt, [&]() { return !teardownAt || stop; });
+            if (stop || !teardownAt || std::chrono::steady_clock::now() < *teardownAt)
+            {
+                continue;
+            }
+
+            teardownAt.reset();
+            if (!active && !teardown())
+            {
+                Fancy::fancy.logTime().warning() << "Failed to move output apps back after playback" << std::endl;
+            }
+        }
+    }
+    bool Router::apply(const std::vector<std::string> &outputs)
+    {
+        auto backend = Globals::gAudioBackend;
+        if (!backend)
+        {
+            return false;
+        }
+
+        std::set<std::string> desired(outputs.begin(), outputs.end());
+
+        std::set<std::string> removed;
+        for (const auto &app : routed)
+        {
+            if (!desired.count(app))
+            {
+                removed.emplace(app);
+            }
+        }
+
+        if (!removed.empty())
+        {
+            backend->stopSoundInputFor(removed);
+            for (const auto &app : removed)
+            {
+                routed.erase(app);
+            }
+        }
+
+        std::vector<std::shared_ptr<RecordingApp>> missing;
+        for (const auto &app : desired)
+        {
+            //* Apps that were restarted come back with new streams under the same name, so the name alone is not enough
+            if (routed.count(app) && backend->isSoundInputLive(app))
+            {
+                continue;
+            }
+
+            routed.erase(app);
+            if (auto recordingApp = backend->getRecordingApp(app); recordingApp)
+            {
+                missing.emplace_back(recordingApp);
+            }
+        }
+
+        //* All outputs are routed with a single round trip
+        if (!missing.empty())
+        {
+            auto added = backend->inputSoundToAll(missing);
+            routed.insert(added.begin(), added.end());
+        }
+
+        return !routed.empty();
+    }
+    bool Router::teardown()
+    {
+        auto backend = Globals::gAudioBackend;
+        if (routed.empty() || !backend)
+        {
+            routed.clear();
+            return true;
+        }
+
+        routed.clear();
+        return backend->stopSoundInput();
+    }
+    bool Router::acquire()
+    {
+        std::lock_guard lock(mutex);
+        active = true;
+        teardownAt.reset();
+
+        return apply(Globals::gSettings.outputs);
+    }
+    bool Router::prime()
+    {
+        std::lock_guard lock(mutex);
+        if (active)
+        {
+            return !routed.empty();
+        }
+
+        auto rtn = apply(Globals::gSettings.outputs);
+        if (!Globals::gAudio.hasRemoteBus() && !routed.empty())
+        {
+            teardownAt =
+                std::chrono::steady_clock::now() + std::chrono::milliseconds(Globals::gSettings.routingLingerInMs);
+            cv.notify_all();
+        }
+
+        return rtn;
+    }
+    void Router::release()
+    {
+        std::lock_guard lock(mutex);
+        active = false;
+
+        //* With the remote bus the apps stay routed for as long as it is running
+        if (Globals::gAudio.hasRemoteBus() || routed.empty())
+        {
+            return;
+        }
+
+        teardownAt = std::chrono::steady_clock::now() + std::chrono::milliseconds(Globals::gSettings.routingLingerInMs);
+        cv.notify_all();
+    }
+    bool Router::update()
+    {
+        std::lock_guard lock(mutex);
+        if (active || Globals::gAudio.hasRemoteBus())
+        {
+            return apply(Globals::gSettings.outputs);
+        }
+
+        //* Nothing plays, so there is no need to route the new outputs yet
+        std::vector<std::string> remaining;
+        for (const auto &app : Globals::gSettings.outputs)
+        {
+            if (routed.count(app))
+            {
+                remaining.emplace_back(app);
+            }
+        }
+
+        apply(remaining);
+        return true;
+    }
+    bool Router::clear()
+    {
+        std::lock_guard lock(mutex);
+        teardownAt.reset();
+
+        return teardown();
+    }
+    void Router::reset()
+    {
+        std::lock_guard lock(mutex);
+        teardownAt.reset();
+        routed.clear();
+        active = false;
+    }
+} // namespace Soundux::Objects
+#endif
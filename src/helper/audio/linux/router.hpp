@@ -0,0 +1,55 @@
+#pragma once
+#if defined(__linux__)
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Soundux
+{
+    namespace Objects
+    {
+        //* Keeps the output apps routed to our sink while anything plays and for a short while after, so that
+        //* triggering a sound in steady state only checks the cached state of the backend instead of re-routing.
+        class Router
+        {
+            std::set<std::string> routed;
+            bool active = false;
+            std::optional<std::chrono::steady_clock::time_point> teardownAt;
+
+            std::mutex mutex;
+            std::condition_variable cv;
+            std::atomic<bool> stop = false;
+            std::thread handler;
+
+          private:
+            void handle();
+            bool apply(const std::vector<std::string> &);
+            bool teardown();
+
+          public:
+            Router();
+            ~Router();
+
+            //* Called whenever something starts playing, returns whether at least one output is routed
+            bool acquire();
+            //* Routes the outputs ahead of a sound that is about to play, they linger like after a release
+            bool prime();
+            //* Called once nothing plays anymore, routes are torn down after the linger window
+            void release();
+
+            //* Re-applies the configured outputs, only touches the routes that actually changed
+            bool update();
+            //* Tears down all routes right away
+            bool clear();
+            //* Forgets all routes without touching the backend, used when the backend is replaced
+            void reset();
+        };
+    } // namespace Objects
+} // namespace Soundux
+#endif
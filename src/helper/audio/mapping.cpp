@@ -0,0 +1,158 @@
+#include "mapping.hpp"
+#include <fancy.hpp>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#include <helper/misc/misc.hpp>
+#endif
+
+namespace Soundux::Objects
+{
+#if defined(_WIN32)
+    using Soundux::Helpers::widen;
+#endif
+
+    std::shared_ptr<FileMapping> FileMapping::createInstance(const std::string &path)
+    {
+        auto instance = std::shared_ptr<FileMapping>(new FileMapping()); // NOLINT
+
+#if defined(__linux__)
+        auto fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            Fancy::fancy.logTime().warning() << "Failed to open " << path << " for mapping" << std::endl;
+            return nullptr;
+        }
+
+        struct stat info
+        {
+        };
+        if (fstat(fd, &info) != 0 || info.st_size <= 0)
+        {
+            close(fd);
+            return nullptr;
+        }
+
+        auto *data = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+
+        if (data == MAP_FAILED)
+        {
+            Fancy::fancy.logTime().warning() << "Failed to map " << path << std::endl;
+            return nullptr;
+        }
+
+        madvise(data, static_cast<std::size_t>(info.st_size), MADV_WILLNEED);
+
+        instance->data = data;
+        instance->size = static_cast<std::size_t>(info.st_size);
+#elif defined(_WIN32)
+        instance->file = CreateFileW(widen(path).c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                                     OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (instance->file == INVALID_HANDLE_VALUE)
+        {
+            Fancy::fancy.logTime().warning() << "Failed to open " << path << " for mapping" << std::endl;
+            return nullptr;
+        }
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(instance->file, &size) || size.QuadPart <= 0)
+        {
+            return nullptr;
+        }
+
+        instance->mapping = CreateFileMappingW(instance->file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!instance->mapping)
+        {
+            Fancy::fancy.logTime().warning() << "Failed to map " << path << std::endl;
+            return nullptr;
+        }
+
+        instance->data = MapViewOfFile(instance->mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!instance->data)
+        {
+            Fancy::fancy.logTime().warning() << "Failed to map " << path << std::endl;
+            return nullptr;
+        }
+
+        instance->size = static_cast<std::size_t>(size.QuadPart);
+#endif
+
+        return instance;
+    }
+    FileMapping::~FileMapping()
+    {
+#if defined(__linux__)
+        if (data)
+        {
+            munmap(const_cast<void *>(data), size);
+        }
+#elif defined(_WIN32)
+        if (data)
+        {
+            UnmapViewOfFile(data);
+        }
+        if (mapping)
+        {
+            CloseHandle(mapping);
+        }
+        if (file != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(file);
+        }
+#endif
+    }
+    std::size_t FileMapping::getSize() const
+    {
+        return size;
+    }
+    const void *FileMapping::getData() const
+    {
+        return data;
+    }
+
+    std::shared_ptr<FileMapping> FileMappings::get(const Sound &sound, bool *wasMapped)
+    {
+        auto scoped = mappings.scoped();
+
+        auto entry = scoped->find(sound.path);
+        if (entry != scoped->end() && entry->second.modifiedDate == sound.modifiedDate)
+        {
+            if (auto mapping = entry->second.mapping.lock(); mapping)
+            {
+                if (wasMapped)
+                {
+                    *wasMapped = true;
+                }
+                return mapping;
+            }
+        }
+
+        if (wasMapped)
+        {
+            *wasMapped = false;
+        }
+
+        for (auto it = scoped->begin(); it != scoped->end();)
+        {
+            it = it->second.mapping.expired() ? scoped->erase(it) : std::next(it);
+        }
+
+        //* Voices that still use an outdated mapping keep it alive until they are done
+        auto mapping = FileMapping::createInstance(sound.path);
+        if (mapping)
+        {
+            scoped->insert_or_assign(sound.path, Entry{sound.modifiedDate, mapping});
+        }
+        else
+        {
+            scoped->erase(sound.path);
+        }
+
+        return mapping;
+    }
+} // namespace Soundux::Objects
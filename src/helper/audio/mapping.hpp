@@ -0,0 +1,56 @@
+#pragma once
+#include <core/objects/objects.hpp>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <var_guard.hpp>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#endif
+
+namespace Soundux
+{
+    namespace Objects
+    {
+        //* Read-only view of a whole file, unmapped once the last user releases it.
+        class FileMapping
+        {
+            std::size_t size = 0;
+            const void *data = nullptr;
+
+#if defined(_WIN32)
+            HANDLE file = INVALID_HANDLE_VALUE;
+            HANDLE mapping = nullptr;
+#endif
+
+            FileMapping() = default;
+
+          public:
+            FileMapping(const FileMapping &) = delete;
+            FileMapping &operator=(const FileMapping &) = delete;
+            ~FileMapping();
+
+            std::size_t getSize() const;
+            const void *getData() const;
+
+            static std::shared_ptr<FileMapping> createInstance(const std::string &);
+        };
+
+        class FileMappings
+        {
+            struct Entry
+            {
+                std::uint64_t modifiedDate;
+                std::weak_ptr<FileMapping> mapping;
+            };
+
+            sxl::var_guard<std::map<std::string, Entry>> mappings;
+
+          public:
+            //* wasMapped tells whether the file was mapped already, e.g. because it is preloaded
+            std::shared_ptr<FileMapping> get(const Sound &, bool *wasMapped = nullptr);
+        };
+    } // namespace Objects
+} // namespace Soundux
@@ -0,0 +1,120 @@
+#include "metadata.hpp"
+#include <algorithm>
+#include <cctype>
+#include <core/config/config.hpp>
+#include <core/global/globals.hpp>
+#include <fancy.hpp>
+#include <miniaudio.h>
+#include <nlohmann/json.hpp>
+#if defined(_WIN32)
+#include <helper/misc/misc.hpp>
+#endif
+
+namespace Soundux::Objects
+{
+#if defined(_WIN32)
+    using Soundux::Helpers::widen;
+#endif
+
+    std::optional<Metadata> MetadataIndex::probe(const Job &job)
+    {
+        const auto &path = job.path;
+
+        //* No conversion is requested, the decoder reports the native format of the file
+        auto config = ma_decoder_config_init(ma_format_unknown, 0, 0);
+
+        ma_decoder decoder;
+#if defined(_WIN32)
+        auto res = ma_decoder_init_file_w(widen(path).c_str(), &config, &decoder);
+#else
+        auto res = ma_decoder_init_file(path.c_str(), &config, &decoder);
+#endif
+        if (res != MA_SUCCESS)
+        {
+            Fancy::fancy.logTime().warning() << "Failed to probe " << path << std::endl;
+            return std::nullopt;
+        }
+
+        Metadata rtn;
+        rtn.modifiedDate = job.modifiedDate;
+        rtn.sampleRate = decoder.outputSampleRate;
+        rtn.channels = decoder.outputChannels;
+        rtn.length = ma_decoder_get_length_in_pcm_frames(&decoder);
+
+        ma_decoder_uninit(&decoder);
+
+        if (rtn.sampleRate > 0)
+        {
+            rtn.lengthInMs = rtn.length * 1000 / rtn.sampleRate;
+        }
+
+        rtn.format = std::filesystem::u8path(path).extension().u8string();
+        if (!rtn.format.empty())
+        {
+            rtn.format.erase(0, 1);
+            std::transform(rtn.format.begin(), rtn.format.end(), rtn.format.begin(),
+                           [](char c) { return std::tolower(c); });
+        }
+
+        return rtn;
+    }
+    std::filesystem::path MetadataIndex::getPath()
+    {
+        return std::filesystem::u8path(Config::path).parent_path() / "metadata.json";
+    }
+    void MetadataIndex::load()
+    {
+        index.load();
+    }
+    void MetadataIndex::save()
+    {
+        index.save();
+    }
+    void MetadataIndex::enqueue(const Sound &sound)
+    {
+        index.enqueue(sound.path, sound.modifiedDate);
+    }
+    std::optional<Metadata> MetadataIndex::get(const Sound &sound)
+    {
+        return index.get(sound.path, sound.modifiedDate);
+    }
+
+    MetadataIndex::MetadataIndex()
+    {
+        BackgroundIndex<Metadata>::Handlers handlers;
+        handlers.process = &MetadataIndex::probe;
+
+        //* Sounds that are sorted by length were put last until now, they have to be sorted again
+        handlers.onDrained = [] {
+            if (Globals::gGui)
+            {
+                Globals::gGui->onMetadataIndexed();
+            }
+        };
+
+        handlers.toJson = [](const Metadata &metadata) {
+            return nlohmann::json{
+                {"modifiedDate", metadata.modifiedDate},
+                {"format", metadata.format},
+                {"sampleRate", metadata.sampleRate},
+                {"channels", metadata.channels},
+                {"length", metadata.length},
+                {"lengthInMs", metadata.lengthInMs},
+            };
+        };
+        handlers.fromJson = [](const nlohmann::json &entry) {
+            Metadata metadata;
+            entry.at("modifiedDate").get_to(metadata.modifiedDate);
+            entry.at("format").get_to(metadata.format);
+            entry.at("sampleRate").get_to(metadata.sampleRate);
+            entry.at("channels").get_to(metadata.channels);
+            entry.at("length").get_to(metadata.length);
+            entry.at("lengthInMs").get_to(metadata.lengthInMs);
+
+            return metadata;
+        };
+
+        //* Probing mostly waits for the disk, a few threads are enough to keep it busy
+        index.start(std::move(handlers), std::clamp<unsigned int>(std::thread::hardware_concurrency(), 1, 4));
+    }
+} // namespace Soundux::Objects
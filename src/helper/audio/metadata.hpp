@@ -0,0 +1,49 @@
+#pragma once
+#include <core/objects/objects.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <helper/audio/index.hpp>
+#include <optional>
+#include <string>
+
+namespace Soundux
+{
+    namespace Objects
+    {
+        struct Metadata
+        {
+            std::uint64_t modifiedDate = 0;
+
+            std::string format;
+            std::uint32_t sampleRate = 0;
+            std::uint32_t channels = 0;
+
+            std::uint64_t length = 0;
+            std::uint64_t lengthInMs = 0;
+        };
+
+        //* Knows the duration and format of sounds without them having to be played, filled by probing the headers of
+        //* sounds on a few background threads
+        class MetadataIndex
+        {
+            using Job = BackgroundIndex<Metadata>::Job;
+
+            BackgroundIndex<Metadata> index{"metadata index", &MetadataIndex::getPath};
+
+          private:
+            static std::optional<Metadata> probe(const Job &);
+
+          public:
+            MetadataIndex();
+
+            //* Loads the index of previous runs, has to be called before the first sound is enqueued
+            void load();
+            void save();
+
+            void enqueue(const Sound &);
+            std::optional<Metadata> get(const Sound &);
+
+            static std::filesystem::path getPath();
+        };
+    } // namespace Objects
+} // namespace Soundux
@@ -0,0 +1,88 @@
+#include "meter.hpp"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define METER_SSE
+#include <emmintrin.h>
+#endif
+
+namespace Soundux::Objects
+{
+    static void measure(const float *samples, std::size_t count, float &peak, float &sum)
+    {
+        std::size_t i = 0;
+
+#if defined(METER_SSE)
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+        __m128 peaks = _mm_setzero_ps();
+        __m128 sums = _mm_setzero_ps();
+
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128 value = _mm_loadu_ps(samples + i);
+            peaks = _mm_max_ps(peaks, _mm_and_ps(value, absMask));
+            sums = _mm_add_ps(sums, _mm_mul_ps(value, value));
+        }
+
+        alignas(16) float lanes[4];
+        _mm_store_ps(lanes, peaks);
+        peak = std::max({peak, lanes[0], lanes[1], lanes[2], lanes[3]});
+
+        _mm_store_ps(lanes, sums);
+        sum += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+
+        for (; i < count; i++)
+        {
+            peak = std::max(peak, std::fabs(samples[i]));
+            sum += samples[i] * samples[i];
+        }
+    }
+
+    void Meter::setup(std::uint32_t sampleRate, std::uint32_t channels)
+    {
+        publishInterval = std::max<std::uint64_t>(sampleRate / rate, 1);
+        this->channels = std::max<std::uint32_t>(channels, 1);
+    }
+    void Meter::publish()
+    {
+        peak.store(blockPeak, std::memory_order_relaxed);
+        rms.store(blockSamples > 0 ? static_cast<float>(std::sqrt(blockSum / static_cast<double>(blockSamples))) : 0.f,
+                  std::memory_order_relaxed);
+
+        blockPeak = 0.f;
+        blockSum = 0.0;
+        blockSamples = 0;
+        blockFrames = 0;
+    }
+    void Meter::process(const float *samples, std::uint64_t frames, std::uint32_t channels)
+    {
+        float sum = 0.f;
+        measure(samples, static_cast<std::size_t>(frames * channels), blockPeak, sum);
+
+        blockSum += sum;
+        blockSamples += frames * channels;
+        blockFrames += frames;
+
+        if (blockFrames >= publishInterval)
+        {
+            publish();
+        }
+    }
+    void Meter::silence(std::uint64_t frames)
+    {
+        //* Silent samples count towards the RMS just like the ones passed to process
+        blockFrames += frames;
+        blockSamples += frames * channels;
+
+        if (blockFrames >= publishInterval)
+        {
+            publish();
+        }
+    }
+    Levels Meter::get() const
+    {
+        return {peak.load(std::memory_order_relaxed), rms.load(std::memory_order_relaxed)};
+    }
+} // namespace Soundux::Objects
@@ -0,0 +1,42 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+namespace Soundux
+{
+    namespace Objects
+    {
+        struct Levels
+        {
+            float peak = 0.f;
+            float rms = 0.f;
+        };
+
+        //* Peak and RMS level of an audio signal, measured by the audio thread and published about 30 times a second
+        class Meter
+        {
+            std::atomic<float> peak = 0.f;
+            std::atomic<float> rms = 0.f;
+
+            //* Only ever touched by the audio thread
+            float blockPeak = 0.f;
+            double blockSum = 0.0;
+            std::uint64_t blockSamples = 0;
+            std::uint64_t blockFrames = 0;
+            std::uint64_t publishInterval = 1600;
+            std::uint32_t channels = 1;
+
+            void publish();
+
+          public:
+            static constexpr std::uint32_t rate = 30;
+
+            void setup(std::uint32_t sampleRate, std::uint32_t channels);
+
+            void process(const float *samples, std::uint64_t frames, std::uint32_t channels);
+            void silence(std::uint64_t frames);
+
+            Levels get() const;
+        };
+    } // namespace Objects
+} // namespace Soundux
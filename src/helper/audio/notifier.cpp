@@ -0,0 +1,58 @@
+#include "notifier.hpp"
+#include <chrono>
+#include <core/global/globals.hpp>
+
+namespace Soundux::Objects
+{
+    void Notifier::handle()
+    {
+        std::unique_lock lock(mutex);
+        while (!stop)
+        {
+            cv.wait(lock, [&]() { return active || stop; });
+
+            lock.unlock();
+            Globals::gAudio.collectFinished();
+
+            auto playingSounds = Globals::gAudio.getPlayingSounds();
+            for (const auto &sound : playingSounds)
+            {
+                //* Sounds are played twice, once locally and once remotely. Only the local one is shown.
+                if (Globals::gGui && !sound.paused && sound.info->playbackDevice.isDefault)
+                {
+                    Globals::gGui->onSoundProgressed(sound);
+                }
+            }
+            lock.lock();
+
+            if (playingSounds.empty() && !woken)
+            {
+                active = false;
+                continue;
+            }
+
+            woken = false;
+            cv.wait_for(lock, std::chrono::milliseconds(1000 / Meter::rate), [&]() { return stop.load(); });
+        }
+    }
+    void Notifier::notify()
+    {
+        std::unique_lock lock(mutex);
+        active = true;
+        woken = true;
+        lock.unlock();
+
+        cv.notify_one();
+    }
+
+    Notifier::Notifier()
+    {
+        handler = std::thread([this] { handle(); });
+    }
+    Notifier::~Notifier()
+    {
+        stop = true;
+        cv.notify_all();
+        handler.join();
+    }
+} // namespace Soundux::Objects
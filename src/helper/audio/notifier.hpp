@@ -0,0 +1,34 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace Soundux
+{
+    namespace Objects
+    {
+        //* Forwards the progress and levels of the playing sounds to the gui and finishes the sounds that played to
+        //* their end, so that the audio thread never has to
+        class Notifier
+        {
+            bool active = false;
+            bool woken = false;
+            std::mutex mutex;
+
+            std::condition_variable cv;
+            std::atomic<bool> stop = false;
+            std::thread handler;
+
+          private:
+            void handle();
+
+          public:
+            Notifier();
+            ~Notifier();
+
+            //* Called whenever a sound starts playing
+            void notify();
+        };
+    } // namespace Objects
+} // namespace Soundux
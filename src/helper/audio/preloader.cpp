@@ -0,0 +1,262 @@
+#include "preloader.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <core/global/globals.hpp>
+#include <filesystem>
+#include <vector>
+
+namespace Soundux::Objects
+{
+    std::int64_t Preloader::now()
+    {
+        return std::chrono::duration_cast<std::chrono::seconds>(
+                   std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    }
+    double Preloader::decayed(const PlayStatistic &statistic, std::int64_t time)
+    {
+        auto age = static_cast<double>(std::max<std::int64_t>(time - statistic.lastPlayed, 0));
+        return statistic.score * std::exp2(-age / halfLifeInSeconds);
+    }
+    void Preloader::onPlayed(const std::uint32_t &soundId)
+    {
+        auto index = head.fetch_add(1, std::memory_order_acq_rel);
+        events[index % events.size()].store(soundId, std::memory_order_release);
+
+        cv.notify_one();
+    }
+    void Preloader::update()
+    {
+        shouldRefresh = true;
+        cv.notify_one();
+    }
+    void Preloader::setStatistics(const std::map<std::string, PlayStatistic> &other)
+    {
+        *statistics.scoped() = other;
+        update();
+    }
+    std::map<std::string, PlayStatistic> Preloader::getStatistics()
+    {
+        return statistics.copy();
+    }
+    bool Preloader::drain()
+    {
+        auto end = head.load(std::memory_order_acquire);
+
+        //* We fell behind by more than the ring holds, the oldest plays are lost
+        if (end - tail > events.size())
+        {
+            tail = end - events.size();
+        }
+
+        bool drained = false;
+        auto time = now();
+
+        for (; tail < end; tail++)
+        {
+            auto soundId = events[tail % events.size()].exchange(0, std::memory_order_acq_rel);
+            if (soundId == 0)
+            {
+                //* Claimed but not written yet, it is picked up on the next wake
+                break;
+            }
+
+            auto sound = Globals::gData.getSound(soundId);
+            if (!sound)
+            {
+                continue;
+            }
+
+            const auto &path = sound->get().path;
+            ids.insert_or_assign(path, soundId);
+
+            auto scoped = statistics.scoped();
+            auto &statistic = (*scoped)[path];
+
+            statistic.score = decayed(statistic, time) + 1;
+            statistic.lastPlayed = time;
+            statistic.count++;
+
+            drained = true;
+        }
+
+        return drained;
+    }
+    std::optional<std::uint32_t> Preloader::resolve(const std::string &path)
+    {
+        if (auto id = ids.find(path); id != ids.end())
+        {
+            if (auto sound = Globals::gData.getSound(id->second); sound && sound->get().path == path)
+            {
+                return id->second;
+            }
+        }
+        else if (unknown.count(path))
+        {
+            return std::nullopt;
+        }
+
+        //* Either the library changed or the path was never seen, ids are only rebuilt once per refresh
+        if (!rebuilt)
+        {
+            rebuilt = true;
+
+            ids.clear();
+            unknown.clear();
+
+            auto scoped = Globals::gSounds.scoped();
+            for (const auto &[id, sound] : *scoped)
+            {
+                ids.emplace(sound.get().path, id);
+            }
+        }
+
+        if (auto id = ids.find(path); id != ids.end())
+        {
+            return id->second;
+        }
+
+        unknown.emplace(path);
+        return std::nullopt;
+    }
+    void Preloader::refresh()
+    {
+        auto time = now();
+        auto budget = static_cast<std::uintmax_t>(Globals::gSettings.preloadBudgetInMb) * 1024 * 1024;
+
+        rebuilt = false;
+
+        std::vector<std::pair<double, std::string>> ranking;
+        {
+            auto scoped = statistics.scoped();
+            for (const auto &[path, statistic] : *scoped)
+            {
+                ranking.emplace_back(decayed(statistic, time), path);
+            }
+        }
+        std::sort(ranking.begin(), ranking.end(), std::greater<>());
+
+        //* Only the sounds that are considered are looked up, the ranking may hold paths that are gone by now
+        std::vector<std::pair<std::string, std::uint32_t>> candidates;
+        for (const auto &[score, path] : ranking)
+        {
+            if (candidates.size() >= perTab)
+            {
+                break;
+            }
+
+            auto id = resolve(path);
+            if (!id)
+            {
+                continue;
+            }
+
+            auto location = Globals::gData.locateSound(*id);
+            if (location && location->tabId == Globals::gSettings.selectedTab)
+            {
+                candidates.emplace_back(path, *id);
+            }
+        }
+        for (const auto &[score, path] : ranking)
+        {
+            auto isCandidate = [&](const auto &candidate) { return candidate.first == path; };
+            if (std::find_if(candidates.begin(), candidates.end(), isCandidate) != candidates.end())
+            {
+                continue;
+            }
+
+            if (auto id = resolve(path); id)
+            {
+                candidates.emplace_back(path, *id);
+            }
+        }
+
+        std::map<std::string, std::shared_ptr<FileMapping>> next;
+        std::uintmax_t used = 0;
+
+        for (const auto &[path, id] : candidates)
+        {
+            if (used >= budget)
+            {
+                break;
+            }
+
+            std::error_code ec;
+            auto size = std::filesystem::file_size(std::filesystem::u8path(path), ec);
+            if (ec || used + size > budget)
+            {
+                continue;
+            }
+
+            auto sound = Globals::gData.getSound(id);
+            if (!sound)
+            {
+                continue;
+            }
+
+            auto mapping = Globals::gAudio.mappings.get(sound->get());
+            if (!mapping)
+            {
+                continue;
+            }
+
+            //* Newly kept sounds are paged in right away, so that playing them never waits for the disk
+            if (resident.find(path) == resident.end())
+            {
+                const auto *data = reinterpret_cast<const volatile std::uint8_t *>(mapping->getData());
+                for (std::size_t offset = 0; mapping->getSize() > offset; offset += 4096)
+                {
+                    static_cast<void>(data[offset]);
+                }
+            }
+
+            used += size;
+            next.emplace(path, std::move(mapping));
+        }
+
+        resident = std::move(next);
+    }
+    void Preloader::handle()
+    {
+        while (!stop)
+        {
+            {
+                std::unique_lock lock(mutex);
+                cv.wait_for(lock, std::chrono::seconds(1), [&]() {
+                    return stop || shouldRefresh || head.load(std::memory_order_acquire) != tail;
+                });
+            }
+
+            if (stop)
+            {
+                break;
+            }
+
+            auto played = drain();
+            auto requested = shouldRefresh.exchange(false);
+
+            if (requested || played)
+            {
+                //* Paths that were not part of the library are looked up again whenever something changed
+                if (requested)
+                {
+                    unknown.clear();
+                }
+
+                refresh();
+            }
+        }
+    }
+
+    Preloader::Preloader()
+    {
+        handler = std::thread([this] { handle(); });
+    }
+    Preloader::~Preloader()
+    {
+        stop = true;
+        cv.notify_all();
+        handler.join();
+    }
+} // namespace Soundux::Objects
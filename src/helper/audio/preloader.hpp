@@ -0,0 +1,79 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <helper/audio/mapping.hpp>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <thread>
+#include <var_guard.hpp>
+
+namespace Soundux
+{
+    namespace Objects
+    {
+        struct PlayStatistic
+        {
+            std::uint64_t count = 0;
+            //* Seconds since the unix epoch
+            std::int64_t lastPlayed = 0;
+            //* Play count that decays over time, as of lastPlayed
+            double score = 0;
+        };
+
+        //* Records which sounds get played and keeps the ones that are most likely to be played next mapped and paged
+        //* in, within the configured budget.
+        class Preloader
+        {
+            //* Filled by onPlayed and drained by the preloader thread, slots hold sound ids and 0 marks an empty one
+            std::array<std::atomic<std::uint32_t>, 256> events{};
+            std::atomic<std::uint64_t> head = 0;
+            std::uint64_t tail = 0;
+
+            sxl::var_guard<std::map<std::string, PlayStatistic>> statistics;
+
+            //* Only ever touched by the preloader thread
+            std::map<std::string, std::shared_ptr<FileMapping>> resident;
+            //* Sound ids of ranked paths, learned from plays and rebuilt from the library when they turn out stale
+            std::map<std::string, std::uint32_t> ids;
+            std::set<std::string> unknown;
+            bool rebuilt = false;
+
+            std::mutex mutex;
+            std::condition_variable cv;
+            std::atomic<bool> stop = false;
+            std::atomic<bool> shouldRefresh = false;
+            std::thread handler;
+
+          private:
+            void handle();
+            bool drain();
+            void refresh();
+            std::optional<std::uint32_t> resolve(const std::string &);
+
+            static std::int64_t now();
+            static double decayed(const PlayStatistic &, std::int64_t);
+
+          public:
+            static constexpr double halfLifeInSeconds = 7 * 24 * 60 * 60;
+            //* Sounds of the selected tab that are preferred over the globally most played ones
+            static constexpr std::size_t perTab = 8;
+
+            Preloader();
+            ~Preloader();
+
+            //* Lock-free, called whenever a sound is played
+            void onPlayed(const std::uint32_t &);
+            //* Re-evaluates what is kept, e.g. after the selected tab or the budget changed
+            void update();
+
+            void setStatistics(const std::map<std::string, PlayStatistic> &);
+            std::map<std::string, PlayStatistic> getStatistics();
+        };
+    } // namespace Objects
+} // namespace Soundux
@@ -0,0 +1,104 @@
+#include "reclaimer.hpp"
+#include <core/global/globals.hpp>
+
+namespace Soundux::Objects
+{
+    void Reclaimer::handle()
+    {
+        std::unique_lock lock(pendingMutex);
+        while (true)
+        {
+            auto ready = [&]() { return !pending.empty() || stop || wakeChanged; };
+            if (wakeAt)
+            {
+                cv.wait_until(lock, *wakeAt, ready);
+            }
+            else
+            {
+                cv.wait(lock, ready);
+            }
+            wakeChanged = false;
+
+            if (pending.empty() && stop)
+            {
+                break;
+            }
+
+            if (wakeAt && std::chrono::steady_clock::now() >= *wakeAt && !stop)
+            {
+                wakeAt.reset();
+
+                //* Expired voices are pushed right back to us
+                lock.unlock();
+                Globals::gAudio.prune();
+                lock.lock();
+                continue;
+            }
+
+            if (pending.empty())
+            {
+                continue;
+            }
+
+            auto batch = std::move(pending);
+            pending.clear();
+            busy = true;
+
+            lock.unlock();
+            for (auto &voice : batch)
+            {
+                auto start = std::chrono::steady_clock::now();
+                Globals::gAudio.reclaim(*voice);
+
+                //* The metrics might already be gone when we drain on exit
+                if (!stop)
+                {
+                    Globals::gMetrics.record("reclaim", start, std::chrono::steady_clock::now());
+                }
+            }
+            batch.clear();
+            lock.lock();
+
+            busy = false;
+            idle.notify_all();
+        }
+    }
+    void Reclaimer::push(const std::shared_ptr<Voice> &voice)
+    {
+        std::unique_lock lock(pendingMutex);
+        pending.emplace_back(voice);
+        lock.unlock();
+
+        cv.notify_one();
+    }
+    void Reclaimer::wake(std::chrono::steady_clock::time_point time)
+    {
+        std::unique_lock lock(pendingMutex);
+        if (wakeAt && *wakeAt <= time)
+        {
+            return;
+        }
+
+        wakeAt = time;
+        wakeChanged = true;
+        lock.unlock();
+
+        cv.notify_one();
+    }
+    void Reclaimer::flush()
+    {
+        std::unique_lock lock(pendingMutex);
+        idle.wait(lock, [&]() { return pending.empty() && !busy; });
+    }
+
+    Reclaimer::Reclaimer()
+    {
+        handler = std::thread([this] { handle(); });
+    }
+    Reclaimer::~Reclaimer()
+    {
+        stop = true;
+        cv.notify_all();
+        handler.join();
+    }
+} // namespace Soundux::Objects
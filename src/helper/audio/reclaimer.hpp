@@ -0,0 +1,47 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace Soundux
+{
+    namespace Objects
+    {
+        struct Voice;
+
+        //* Tears down stopped voices in the background, uninitializing a device joins its audio thread which is way
+        //* too slow to do while the playing sounds are locked.
+        class Reclaimer
+        {
+            std::vector<std::shared_ptr<Voice>> pending;
+            std::mutex pendingMutex;
+            bool busy = false;
+            std::optional<std::chrono::steady_clock::time_point> wakeAt;
+            //* Set by wake so that a sleeping handler re-arms its timer on the earlier deadline
+            bool wakeChanged = false;
+
+            std::condition_variable cv;
+            std::condition_variable idle;
+            std::atomic<bool> stop = false;
+            std::thread handler;
+
+          private:
+            void handle();
+
+          public:
+            Reclaimer();
+            ~Reclaimer();
+
+            void push(const std::shared_ptr<Voice> &);
+            //* Prunes the prepared voices of the audio once the given time is reached
+            void wake(std::chrono::steady_clock::time_point);
+            //* Blocks until everything that was pushed so far is released
+            void flush();
+        };
+    } // namespace Objects
+} // namespace Soundux
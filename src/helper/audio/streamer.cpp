@@ -0,0 +1,179 @@
+#include "streamer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <core/global/globals.hpp>
+#include <fancy.hpp>
+
+namespace Soundux::Objects
+{
+    std::shared_ptr<Stream> Stream::createInstance(ma_format format, std::uint32_t channels, std::uint32_t frames)
+    {
+        auto instance = std::make_shared<Stream>();
+        if (ma_pcm_rb_init(format, channels, frames, nullptr, nullptr, &instance->ring) != MA_SUCCESS)
+        {
+            Fancy::fancy.logTime().failure() << "Failed to create stream buffer with " << frames << " frames"
+                                             << std::endl;
+            return nullptr;
+        }
+
+        return instance;
+    }
+    Stream::~Stream()
+    {
+        ma_pcm_rb_uninit(&ring);
+    }
+
+    bool Streamer::fill(Voice &voice)
+    {
+        auto &state = voice.state;
+        auto &stream = *voice.stream;
+        auto *decoder = voice.raw.decoder.load();
+
+        //* The voice was stopped and waits to be removed by the reclaimer
+        if (!decoder)
+        {
+            return false;
+        }
+
+        //* The callback still has to drop the frames it buffered from the old position
+        if (stream.flush)
+        {
+            return false;
+        }
+
+        if (stream.seekPending)
+        {
+            ma_decoder_seek_to_pcm_frame(decoder, voice.info->offset + stream.flushTo);
+            stream.seekPending = false;
+            stream.eof = false;
+        }
+
+        if (state.shouldSeek)
+        {
+            stream.flushTo = state.seekTo.load();
+            stream.seekPending = true;
+            state.shouldSeek = false;
+            stream.flush = true;
+
+            return false;
+        }
+
+        if (stream.eof)
+        {
+            if (!state.repeat)
+            {
+                return false;
+            }
+
+            ma_decoder_seek_to_pcm_frame(decoder, voice.info->offset);
+            stream.eof = false;
+        }
+
+        bool looped = false;
+        bool wroteFrames = false;
+
+        while (true)
+        {
+            ma_uint32 frames = ma_pcm_rb_available_write(&stream.ring);
+            if (frames == 0)
+            {
+                break;
+            }
+
+            void *buffer = nullptr;
+            if (ma_pcm_rb_acquire_write(&stream.ring, &frames, &buffer) != MA_SUCCESS)
+            {
+                break;
+            }
+
+            auto readFrames = static_cast<ma_uint32>(ma_decoder_read_pcm_frames(decoder, buffer, frames));
+            ma_pcm_rb_commit_write(&stream.ring, readFrames, buffer);
+
+            if (readFrames > 0)
+            {
+                looped = false;
+                wroteFrames = true;
+            }
+
+            if (readFrames < frames)
+            {
+                //* Looping is done here so that the callback never sees a gap at the loop point
+                if (state.repeat && !looped)
+                {
+                    ma_decoder_seek_to_pcm_frame(decoder, voice.info->offset);
+                    looped = true;
+                    continue;
+                }
+
+                stream.eof = true;
+                break;
+            }
+        }
+
+        return wroteFrames;
+    }
+    void Streamer::handle()
+    {
+        std::vector<std::shared_ptr<Voice>> snapshot;
+
+        std::unique_lock lock(voicesMutex);
+        while (!stop)
+        {
+            cv.wait(lock, [&]() { return !voices.empty() || stop; });
+            snapshot = voices;
+            lock.unlock();
+
+            {
+                std::lock_guard fillLock(fillMutex);
+                for (auto &voice : snapshot)
+                {
+                    fill(*voice);
+                }
+            }
+
+            snapshot.clear();
+            lock.lock();
+
+            auto interval = std::clamp<std::uint32_t>(Globals::gSettings.streamReadAheadInMs / 4, 5, 50);
+            cv.wait_for(lock, std::chrono::milliseconds(interval));
+        }
+    }
+
+    void Streamer::add(const std::shared_ptr<Voice> &voice)
+    {
+        //* Pre-fill the buffer so that the first callback already has data to play, the streaming thread does not
+        //* know about the voice yet so this needs no lock
+        fill(*voice);
+
+        std::unique_lock lock(voicesMutex);
+        voices.emplace_back(voice);
+    }
+    void Streamer::remove(const std::uint32_t &id)
+    {
+        {
+            std::unique_lock lock(voicesMutex);
+            voices.erase(std::remove_if(voices.begin(), voices.end(),
+                                        [&](const std::shared_ptr<Voice> &voice) { return voice->id == id; }),
+                         voices.end());
+        }
+
+        //* A fill pass might still work on a snapshot that contains the voice, once it is done the streaming thread is
+        //* guaranteed to no longer touch the decoder
+        std::unique_lock lock(fillMutex);
+    }
+    void Streamer::notify()
+    {
+        cv.notify_one();
+    }
+
+    Streamer::Streamer()
+    {
+        handler = std::thread([this] { handle(); });
+    }
+    Streamer::~Streamer()
+    {
+        stop = true;
+        cv.notify_all();
+        handler.join();
+    }
+} // namespace Soundux::Objects
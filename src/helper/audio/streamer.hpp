@@ -0,0 +1,62 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <miniaudio.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Soundux
+{
+    namespace Objects
+    {
+        struct Voice;
+
+        //* Single-producer single-consumer ring that is filled by the Streamer and drained by the audio callback.
+        struct Stream
+        {
+            ma_pcm_rb ring;
+
+            std::atomic<bool> eof = false;
+            std::atomic<bool> flush = false;
+            std::atomic<std::uint64_t> flushTo = 0;
+            std::atomic<std::uint64_t> underruns = 0;
+
+            //* Only ever touched by the streaming thread
+            bool seekPending = false;
+
+            Stream() = default;
+            Stream(const Stream &) = delete;
+            Stream &operator=(const Stream &) = delete;
+            ~Stream();
+
+            static std::shared_ptr<Stream> createInstance(ma_format, std::uint32_t, std::uint32_t);
+        };
+
+        class Streamer
+        {
+            std::vector<std::shared_ptr<Voice>> voices;
+            std::mutex voicesMutex;
+            //* Held while decoding, so that adding voices never has to wait for a fill pass
+            std::mutex fillMutex;
+
+            std::condition_variable cv;
+            std::atomic<bool> stop = false;
+            std::thread handler;
+
+          private:
+            void handle();
+            bool fill(Voice &);
+
+          public:
+            Streamer();
+            ~Streamer();
+
+            void add(const std::shared_ptr<Voice> &);
+            void remove(const std::uint32_t &);
+            void notify();
+        };
+    } // namespace Objects
+} // namespace Soundux
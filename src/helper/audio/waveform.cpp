@@ -0,0 +1,262 @@
+#include "waveform.hpp"
+#include <algorithm>
+#include <cmath>
+#include <core/config/config.hpp>
+#include <cstring>
+#include <fancy.hpp>
+#include <fstream>
+#include <helper/audio/mapping.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define WAVEFORM_SSE
+#include <emmintrin.h>
+#endif
+
+namespace Soundux::Objects
+{
+    static constexpr char magic[4] = {'S', 'X', 'W', 'F'};
+    static constexpr std::uint32_t version = 1;
+
+    static void reduce(const float *samples, std::size_t count, float &min, float &max)
+    {
+        std::size_t i = 0;
+
+#if defined(WAVEFORM_SSE)
+        if (count >= 4)
+        {
+            __m128 mins = _mm_set1_ps(min);
+            __m128 maxs = _mm_set1_ps(max);
+
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128 value = _mm_loadu_ps(samples + i);
+                mins = _mm_min_ps(mins, value);
+                maxs = _mm_max_ps(maxs, value);
+            }
+
+            alignas(16) float lanes[4];
+            _mm_store_ps(lanes, mins);
+            min = std::min({min, lanes[0], lanes[1], lanes[2], lanes[3]});
+
+            _mm_store_ps(lanes, maxs);
+            max = std::max({max, lanes[0], lanes[1], lanes[2], lanes[3]});
+        }
+#endif
+
+        for (; i < count; i++)
+        {
+            min = std::min(min, samples[i]);
+            max = std::max(max, samples[i]);
+        }
+    }
+    static std::int8_t quantize(float value)
+    {
+        return static_cast<std::int8_t>(std::lround(std::clamp(value, -1.f, 1.f) * 127.f));
+    }
+
+    WaveformBuilder::WaveformBuilder(std::uint32_t channels) : channels(channels) {}
+    void WaveformBuilder::process(const float *samples, std::uint64_t count)
+    {
+        while (count > 0)
+        {
+            auto take = std::min(count, blockFrames - frames);
+            reduce(samples, static_cast<std::size_t>(take * channels), blockMin, blockMax);
+
+            samples += take * channels;
+            count -= take;
+            frames += take;
+
+            if (frames == blockFrames)
+            {
+                mins.emplace_back(blockMin);
+                maxs.emplace_back(blockMax);
+
+                frames = 0;
+                blockMin = blockMax = 0.f;
+            }
+        }
+    }
+    Waveform WaveformBuilder::finish(std::uint64_t modifiedDate)
+    {
+        if (frames > 0)
+        {
+            mins.emplace_back(blockMin);
+            maxs.emplace_back(blockMax);
+            frames = 0;
+        }
+
+        Waveform rtn;
+        rtn.modifiedDate = modifiedDate;
+
+        if (mins.empty())
+        {
+            return rtn;
+        }
+
+        //* Sounds shorter than the overview stretch their blocks over several buckets
+        for (std::size_t bucket = 0; Waveform::buckets > bucket; bucket++)
+        {
+            auto begin = bucket * mins.size() / Waveform::buckets;
+            auto end = std::max(begin + 1, (bucket + 1) * mins.size() / Waveform::buckets);
+
+            rtn.min[bucket] = quantize(*std::min_element(mins.begin() + begin, mins.begin() + end));
+            rtn.max[bucket] = quantize(*std::max_element(maxs.begin() + begin, maxs.begin() + end));
+        }
+
+        return rtn;
+    }
+
+    std::filesystem::path WaveformCache::getPath()
+    {
+        return std::filesystem::u8path(Config::path).parent_path() / "waveforms.bin";
+    }
+    void WaveformCache::write(std::ostream &stream, const std::string &path, const Waveform &waveform)
+    {
+        auto pathLength = static_cast<std::uint32_t>(path.size());
+        stream.write(reinterpret_cast<const char *>(&pathLength), sizeof(pathLength));
+        stream.write(path.data(), pathLength);
+        stream.write(reinterpret_cast<const char *>(&waveform.modifiedDate), sizeof(waveform.modifiedDate));
+        stream.write(reinterpret_cast<const char *>(waveform.min.data()), Waveform::buckets);
+        stream.write(reinterpret_cast<const char *>(waveform.max.data()), Waveform::buckets);
+    }
+    void WaveformCache::load()
+    {
+        auto path = getPath();
+        if (!std::filesystem::exists(path))
+        {
+            return;
+        }
+
+        std::lock_guard lock(fileMutex);
+        std::size_t records = 0;
+        bool truncated = false;
+
+        {
+            auto mapping = FileMapping::createInstance(path.u8string());
+            if (!mapping)
+            {
+                return;
+            }
+
+            const auto *data = reinterpret_cast<const char *>(mapping->getData());
+            auto size = mapping->getSize();
+
+            //* Invalid or outdated caches are replaced by an empty one, appending to them would never be read back
+            std::uint32_t fileVersion = 0;
+            if (size < sizeof(magic) + sizeof(fileVersion) || std::memcmp(data, magic, sizeof(magic)) != 0)
+            {
+                Fancy::fancy.logTime().warning() << "Ignoring invalid waveform cache " << path.u8string() << std::endl;
+                size = 0;
+                truncated = true;
+            }
+            else
+            {
+                std::memcpy(&fileVersion, data + sizeof(magic), sizeof(fileVersion));
+                if (fileVersion != version)
+                {
+                    size = 0;
+                    truncated = true;
+                }
+            }
+
+            auto scoped = entries.scoped();
+            std::size_t offset = sizeof(magic) + sizeof(fileVersion);
+
+            //* Records are appended, so a later record for the same path supersedes the earlier ones
+            while (size > offset)
+            {
+                if (offset + sizeof(std::uint32_t) > size)
+                {
+                    truncated = true;
+                    break;
+                }
+
+                std::uint32_t pathLength = 0;
+                std::memcpy(&pathLength, data + offset, sizeof(pathLength));
+                offset += sizeof(pathLength);
+
+                if (offset + pathLength + sizeof(std::uint64_t) + 2 * Waveform::buckets > size)
+                {
+                    Fancy::fancy.logTime().warning() << "Waveform cache is truncated" << std::endl;
+                    truncated = true;
+                    break;
+                }
+
+                std::string soundPath(data + offset, pathLength);
+                offset += pathLength;
+
+                auto waveform = std::make_shared<Waveform>();
+                std::memcpy(&waveform->modifiedDate, data + offset, sizeof(waveform->modifiedDate));
+                offset += sizeof(waveform->modifiedDate);
+                std::memcpy(waveform->min.data(), data + offset, Waveform::buckets);
+                offset += Waveform::buckets;
+                std::memcpy(waveform->max.data(), data + offset, Waveform::buckets);
+                offset += Waveform::buckets;
+
+                scoped->insert_or_assign(soundPath, std::move(waveform));
+                records++;
+            }
+        }
+
+        //* Superseded or truncated records are dropped by rewriting the file
+        auto scoped = entries.scoped();
+        if (truncated || records != scoped->size())
+        {
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            file.write(magic, sizeof(magic));
+            file.write(reinterpret_cast<const char *>(&version), sizeof(version));
+
+            for (const auto &[soundPath, waveform] : *scoped)
+            {
+                write(file, soundPath, *waveform);
+            }
+        }
+    }
+    void WaveformCache::store(const std::string &soundPath, const Waveform &waveform)
+    {
+        entries->insert_or_assign(soundPath, std::make_shared<const Waveform>(waveform));
+
+        std::lock_guard lock(fileMutex);
+        auto path = getPath();
+
+        std::error_code ec;
+        auto exists = std::filesystem::exists(path, ec);
+        if (!exists)
+        {
+            std::filesystem::create_directories(path.parent_path(), ec);
+        }
+
+        std::ofstream file(path, std::ios::binary | std::ios::app);
+        if (!file.is_open())
+        {
+            Fancy::fancy.logTime().warning() << "Failed to write waveform cache " << path.u8string() << std::endl;
+            return;
+        }
+
+        if (!exists)
+        {
+            file.write(magic, sizeof(magic));
+            file.write(reinterpret_cast<const char *>(&version), sizeof(version));
+        }
+
+        write(file, soundPath, waveform);
+    }
+    bool WaveformCache::has(const std::string &soundPath, std::uint64_t modifiedDate)
+    {
+        auto scoped = entries.scoped();
+        auto entry = scoped->find(soundPath);
+
+        return entry != scoped->end() && entry->second->modifiedDate == modifiedDate;
+    }
+    std::shared_ptr<const Waveform> WaveformCache::get(const Sound &sound)
+    {
+        auto scoped = entries.scoped();
+        auto entry = scoped->find(sound.path);
+        if (entry != scoped->end() && entry->second->modifiedDate == sound.modifiedDate)
+        {
+            return entry->second;
+        }
+
+        return nullptr;
+    }
+} // namespace Soundux::Objects
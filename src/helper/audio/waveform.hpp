@@ -0,0 +1,63 @@
+#pragma once
+#include <array>
+#include <core/objects/objects.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <var_guard.hpp>
+#include <vector>
+
+namespace Soundux
+{
+    namespace Objects
+    {
+        //* Min/max overview of a whole sound, all channels folded into one and quantized to 8 bits
+        struct Waveform
+        {
+            static constexpr std::size_t buckets = 512;
+
+            std::uint64_t modifiedDate = 0;
+            std::array<std::int8_t, buckets> min{};
+            std::array<std::int8_t, buckets> max{};
+        };
+
+        //* Reduces decoded audio to a Waveform without knowing its length up front
+        class WaveformBuilder
+        {
+            static constexpr std::uint64_t blockFrames = 256;
+
+            std::uint32_t channels;
+            std::uint64_t frames = 0;
+            float blockMin = 0.f, blockMax = 0.f;
+
+            std::vector<float> mins, maxs;
+
+          public:
+            WaveformBuilder(std::uint32_t channels);
+
+            void process(const float *samples, std::uint64_t count);
+            Waveform finish(std::uint64_t modifiedDate);
+        };
+
+        //* All overviews live in a single file, that is mapped once on start up and only ever appended to afterwards
+        class WaveformCache
+        {
+            sxl::var_guard<std::map<std::string, std::shared_ptr<const Waveform>>> entries;
+            std::mutex fileMutex;
+
+            static void write(std::ostream &, const std::string &, const Waveform &);
+
+          public:
+            void load();
+            void store(const std::string &, const Waveform &);
+
+            bool has(const std::string &, std::uint64_t modifiedDate);
+            std::shared_ptr<const Waveform> get(const Sound &);
+
+            static std::filesystem::path getPath();
+        };
+    } // namespace Objects
+} // namespace Soundux
@@ -29,6 +29,9 @@
 
    René Nyffenegger rene.nyffenegger@adp-gmbh.ch
 
+   Altered for Soundux: the encoder writes into a preallocated buffer and
+   uses SSSE3/AVX2 for the bulk of the input when the CPU supports it.
+
 */
 
 #include "base64.hpp"
@@ -36,6 +39,17 @@
 #include <algorithm>
 #include <stdexcept>
 
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define BASE64_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define BASE64_TARGET(x)
+#else
+#define BASE64_TARGET(x) __attribute__((target(x)))
+#endif
+#endif
+
 //
 // Depending on the url parameter in base64_chars, one of
 // two sets of base64 characters needs to be chosen.
@@ -116,12 +130,320 @@ template <typename String> static std::string encode(String s, bool url)
     return base64_encode(reinterpret_cast<const unsigned char *>(s.data()), s.length(), url);
 }
 
+//
+// Encodes whole groups of three bytes and the padded tail, returns the amount
+// of characters written to out.
+//
+static size_t encode_scalar(unsigned char const *bytes_to_encode, size_t in_len, char *out, const char *base64_chars_,
+                            char trailing_char)
+{
+    char *begin = out;
+    size_t pos = 0;
+
+    for (; pos + 3 <= in_len; pos += 3)
+    {
+        *out++ = base64_chars_[(bytes_to_encode[pos + 0] & 0xfc) >> 2];
+        *out++ = base64_chars_[((bytes_to_encode[pos + 0] & 0x03) << 4) + ((bytes_to_encode[pos + 1] & 0xf0) >> 4)];
+        *out++ = base64_chars_[((bytes_to_encode[pos + 1] & 0x0f) << 2) + ((bytes_to_encode[pos + 2] & 0xc0) >> 6)];
+        *out++ = base64_chars_[bytes_to_encode[pos + 2] & 0x3f];
+    }
+
+    if (pos + 2 == in_len)
+    {
+        *out++ = base64_chars_[(bytes_to_encode[pos + 0] & 0xfc) >> 2];
+        *out++ = base64_chars_[((bytes_to_encode[pos + 0] & 0x03) << 4) + ((bytes_to_encode[pos + 1] & 0xf0) >> 4)];
+        *out++ = base64_chars_[(bytes_to_encode[pos + 1] & 0x0f) << 2];
+        *out++ = trailing_char;
+    }
+    else if (pos + 1 == in_len)
+    {
+        *out++ = base64_chars_[(bytes_to_encode[pos + 0] & 0xfc) >> 2];
+        *out++ = base64_chars_[(bytes_to_encode[pos + 0] & 0x03) << 4];
+        *out++ = trailing_char;
+        *out++ = trailing_char;
+    }
+
+    return static_cast<size_t>(out - begin);
+}
+
+#if defined(BASE64_X86)
+//
+// Vectorized encoding as described by Wojciech Muła and Daniel Lemire in
+// "Faster Base64 Encoding and Decoding using AVX2 Instructions".
+// Every 128 bit lane turns 12 input bytes into 16 characters.
+//
+BASE64_TARGET("ssse3") static __m128i encode_lane(__m128i in, __m128i shift_lut)
+{
+    in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+
+    const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+    const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+    const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    const __m128i indices = _mm_or_si128(t1, t3);
+
+    __m128i result = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    result = _mm_or_si128(result, _mm_and_si128(less, _mm_set1_epi8(13)));
+
+    return _mm_add_epi8(_mm_shuffle_epi8(shift_lut, result), indices);
+}
+
+BASE64_TARGET("ssse3")
+static size_t encode_ssse3(unsigned char const *bytes_to_encode, size_t in_len, char *out, const char *base64_chars_)
+{
+    const __m128i shift_lut = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                            '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                            static_cast<char>(base64_chars_[62] - 62),
+                                            static_cast<char>(base64_chars_[63] - 63), 'A', 0, 0);
+
+    size_t pos = 0;
+
+    //
+    // Each load reads 16 bytes of which only 12 are consumed
+    //
+    for (; pos + 16 <= in_len; pos += 12)
+    {
+        const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes_to_encode + pos));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), encode_lane(in, shift_lut));
+        out += 16;
+    }
+
+    return pos;
+}
+
+BASE64_TARGET("avx2")
+static size_t encode_avx2(unsigned char const *bytes_to_encode, size_t in_len, char *out, const char *base64_chars_)
+{
+    const __m256i shift_lut = _mm256_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        static_cast<char>(base64_chars_[62] - 62), static_cast<char>(base64_chars_[63] - 63), 'A', 0, 0, 'a' - 26,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        static_cast<char>(base64_chars_[62] - 62), static_cast<char>(base64_chars_[63] - 63), 'A', 0, 0);
+    const __m256i shuffle = _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1, 10, 11, 9, 10, 7, 8, 6,
+                                            7, 4, 5, 3, 4, 1, 2, 0, 1);
+
+    size_t pos = 0;
+
+    //
+    // The upper lane starts 12 bytes after the lower one, so 28 bytes have
+    // to be readable for 24 consumed ones
+    //
+    for (; pos + 28 <= in_len; pos += 24)
+    {
+        const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes_to_encode + pos));
+        const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes_to_encode + pos + 12));
+        __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+
+        in = _mm256_shuffle_epi8(in, shuffle);
+
+        const __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+        const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        const __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+        const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        const __m256i indices = _mm256_or_si256(t1, t3);
+
+        __m256i result = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+        result = _mm256_or_si256(result, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+        result = _mm256_add_epi8(_mm256_shuffle_epi8(shift_lut, result), indices);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), result);
+        out += 32;
+    }
+
+    //
+    // The remainder might still be long enough for the 128 bit version
+    //
+    return pos + encode_ssse3(bytes_to_encode + pos, in_len - pos, out, base64_chars_);
+}
+
+//
+// Vectorized decoding, packing the 6 bit values works like in the paper.
+// The characters are classified by range instead of the paper's lookup
+// tables, so that both alphabets are accepted just like in pos_of_char.
+// Blocks with anything else (padding, line breaks, invalid characters) are
+// left to the scalar loop, which also takes care of reporting errors.
+//
+BASE64_TARGET("ssse3") static __m128i in_range(__m128i in, char lo, char hi)
+{
+    return _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8(static_cast<char>(lo - 1))),
+                         _mm_cmpgt_epi8(_mm_set1_epi8(static_cast<char>(hi + 1)), in));
+}
+
+BASE64_TARGET("ssse3") static bool decode_values(__m128i in, __m128i &values)
+{
+    const __m128i upper = in_range(in, 'A', 'Z');
+    const __m128i lower = in_range(in, 'a', 'z');
+    const __m128i digit = in_range(in, '0', '9');
+    const __m128i c62 = _mm_or_si128(_mm_cmpeq_epi8(in, _mm_set1_epi8('+')), _mm_cmpeq_epi8(in, _mm_set1_epi8('-')));
+    const __m128i c63 = _mm_or_si128(_mm_cmpeq_epi8(in, _mm_set1_epi8('/')), _mm_cmpeq_epi8(in, _mm_set1_epi8('_')));
+
+    const __m128i valid = _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, _mm_or_si128(c62, c63)));
+    if (_mm_movemask_epi8(valid) != 0xffff)
+        return false;
+
+    __m128i shift = _mm_and_si128(upper, _mm_set1_epi8(-'A'));
+    shift = _mm_or_si128(shift, _mm_and_si128(lower, _mm_set1_epi8(26 - 'a')));
+    shift = _mm_or_si128(shift, _mm_and_si128(digit, _mm_set1_epi8(52 - '0')));
+
+    const __m128i special = _mm_or_si128(_mm_and_si128(c62, _mm_set1_epi8(62)), _mm_and_si128(c63, _mm_set1_epi8(63)));
+    values = _mm_or_si128(_mm_andnot_si128(_mm_or_si128(c62, c63), _mm_add_epi8(in, shift)), special);
+
+    return true;
+}
+
+BASE64_TARGET("ssse3")
+static size_t decode_ssse3(unsigned char const *encoded, size_t in_len, char *out)
+{
+    size_t pos = 0;
+
+    //
+    // Every store writes 16 bytes of which only 12 are used, the caller
+    // provides the slack
+    //
+    for (; pos + 16 <= in_len; pos += 16)
+    {
+        __m128i values;
+        if (!decode_values(_mm_loadu_si128(reinterpret_cast<const __m128i *>(encoded + pos)), values))
+            break;
+
+        const __m128i merged = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+        const __m128i packed = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+        const __m128i result =
+            _mm_shuffle_epi8(packed, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), result);
+        out += 12;
+    }
+
+    return pos;
+}
+
+BASE64_TARGET("avx2") static __m256i in_range_avx2(__m256i in, char lo, char hi)
+{
+    return _mm256_and_si256(_mm256_cmpgt_epi8(in, _mm256_set1_epi8(static_cast<char>(lo - 1))),
+                            _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(hi + 1)), in));
+}
+
+BASE64_TARGET("avx2")
+static size_t decode_avx2(unsigned char const *encoded, size_t in_len, char *out)
+{
+    const __m256i shuffle = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1, 2, 1, 0, 6, 5, 4,
+                                             10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+    size_t pos = 0;
+
+    //
+    // Every store writes 32 bytes of which only 24 are used
+    //
+    for (; pos + 32 <= in_len; pos += 32)
+    {
+        const __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(encoded + pos));
+
+        const __m256i upper = in_range_avx2(in, 'A', 'Z');
+        const __m256i lower = in_range_avx2(in, 'a', 'z');
+        const __m256i digit = in_range_avx2(in, '0', '9');
+        const __m256i c62 =
+            _mm256_or_si256(_mm256_cmpeq_epi8(in, _mm256_set1_epi8('+')), _mm256_cmpeq_epi8(in, _mm256_set1_epi8('-')));
+        const __m256i c63 =
+            _mm256_or_si256(_mm256_cmpeq_epi8(in, _mm256_set1_epi8('/')), _mm256_cmpeq_epi8(in, _mm256_set1_epi8('_')));
+
+        const __m256i valid =
+            _mm256_or_si256(_mm256_or_si256(upper, lower), _mm256_or_si256(digit, _mm256_or_si256(c62, c63)));
+        if (_mm256_movemask_epi8(valid) != -1)
+            break;
+
+        __m256i shift = _mm256_and_si256(upper, _mm256_set1_epi8(-'A'));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(lower, _mm256_set1_epi8(26 - 'a')));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(digit, _mm256_set1_epi8(52 - '0')));
+
+        const __m256i special =
+            _mm256_or_si256(_mm256_and_si256(c62, _mm256_set1_epi8(62)), _mm256_and_si256(c63, _mm256_set1_epi8(63)));
+        const __m256i values =
+            _mm256_or_si256(_mm256_andnot_si256(_mm256_or_si256(c62, c63), _mm256_add_epi8(in, shift)), special);
+
+        const __m256i merged = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        __m256i result = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+        result = _mm256_shuffle_epi8(result, shuffle);
+
+        //
+        // Both lanes hold 12 bytes, move them next to each other
+        //
+        result = _mm256_permutevar8x32_epi32(result, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), result);
+        out += 24;
+    }
+
+    return pos + decode_ssse3(encoded + pos, in_len - pos, out);
+}
+
+#endif
+
+using encode_fn = size_t (*)(unsigned char const *, size_t, char *, const char *);
+using decode_fn = size_t (*)(unsigned char const *, size_t, char *);
+
+struct cpu_support
+{
+    bool ssse3 = false;
+    bool avx2 = false;
+};
+
+static cpu_support detect_cpu()
+{
+    cpu_support rtn;
+#if defined(BASE64_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+
+    rtn.ssse3 = (info[2] & (1 << 9)) != 0;
+    //
+    // AVX2 additionally requires the OS to save the ymm registers
+    //
+    const bool os_saves_ymm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+
+    __cpuidex(info, 7, 0);
+    rtn.avx2 = os_saves_ymm && (info[1] & (1 << 5)) != 0;
+#elif defined(BASE64_X86)
+    __builtin_cpu_init();
+    rtn.ssse3 = __builtin_cpu_supports("ssse3");
+    rtn.avx2 = __builtin_cpu_supports("avx2");
+#endif
+    return rtn;
+}
+
+static encode_fn select_encoder()
+{
+#if defined(BASE64_X86)
+    const auto cpu = detect_cpu();
+    if (cpu.avx2)
+        return encode_avx2;
+    if (cpu.ssse3)
+        return encode_ssse3;
+#endif
+    return nullptr;
+}
+
+static decode_fn select_decoder()
+{
+#if defined(BASE64_X86)
+    const auto cpu = detect_cpu();
+    if (cpu.avx2)
+        return decode_avx2;
+    if (cpu.ssse3)
+        return decode_ssse3;
+#endif
+    return nullptr;
+}
+
 std::string base64_encode(unsigned char const *bytes_to_encode, size_t in_len, bool url)
 {
+    static const encode_fn vectorized = select_encoder();
 
     size_t len_encoded = (in_len + 2) / 3 * 4;
 
-    unsigned char trailing_char = url ? '.' : '=';
+    char trailing_char = url ? '.' : '=';
 
     //
     // Choose set of base64 characters. They differ
@@ -134,43 +456,17 @@ std::string base64_encode(unsigned char const *bytes_to_encode, size_t in_len, b
     //
     const char *base64_chars_ = base64_chars[url];
 
-    std::string ret;
-    ret.reserve(len_encoded);
-
-    unsigned int pos = 0;
+    std::string ret(len_encoded, '\0');
+    char *out = ret.data();
 
-    while (pos < in_len)
+    size_t pos = 0;
+    if (vectorized)
     {
-        ret.push_back(base64_chars_[(bytes_to_encode[pos + 0] & 0xfc) >> 2]);
-
-        if (pos + 1 < in_len)
-        {
-            ret.push_back(
-                base64_chars_[((bytes_to_encode[pos + 0] & 0x03) << 4) + ((bytes_to_encode[pos + 1] & 0xf0) >> 4)]);
-
-            if (pos + 2 < in_len)
-            {
-                ret.push_back(
-                    base64_chars_[((bytes_to_encode[pos + 1] & 0x0f) << 2) + ((bytes_to_encode[pos + 2] & 0xc0) >> 6)]);
-                ret.push_back(base64_chars_[bytes_to_encode[pos + 2] & 0x3f]);
-            }
-            else
-            {
-                ret.push_back(base64_chars_[(bytes_to_encode[pos + 1] & 0x0f) << 2]);
-                ret.push_back(trailing_char);
-            }
-        }
-        else
-        {
-
-            ret.push_back(base64_chars_[(bytes_to_encode[pos + 0] & 0x03) << 4]);
-            ret.push_back(trailing_char);
-            ret.push_back(trailing_char);
-        }
-
-        pos += 3;
+        pos = vectorized(bytes_to_encode, in_len, out, base64_chars_);
     }
 
+    encode_scalar(bytes_to_encode + pos, in_len - pos, out + pos / 3 * 4, base64_chars_, trailing_char);
+
     return ret;
 }
 
@@ -203,9 +499,21 @@ template <typename String> static std::string decode(String encoded_string, bool
     // in the encoded string. This approximation is needed to reserve
     // enough space in the string to be returned.
     //
-    size_t approx_length_of_decoded_string = length_of_string / 4 * 3;
-    std::string ret;
-    ret.reserve(approx_length_of_decoded_string);
+    size_t approx_length_of_decoded_string = (length_of_string + 3) / 4 * 3;
+
+    //
+    // The vectorized decoders store a whole register at once, so they need a
+    // few bytes of slack behind the output. It is cut off again below.
+    //
+    std::string ret(approx_length_of_decoded_string + 8, '\0');
+    char *out = ret.data();
+
+    static const decode_fn vectorized = select_decoder();
+    if (vectorized)
+    {
+        pos = vectorized(reinterpret_cast<const unsigned char *>(encoded_string.data()), length_of_string, out);
+        out += pos / 4 * 3;
+    }
 
     while (pos < length_of_string)
     {
@@ -227,8 +535,8 @@ template <typename String> static std::string decode(String encoded_string, bool
         //
         // Emit the first output byte that is produced in each chunk:
         //
-        ret.push_back(static_cast<std::string::value_type>(((pos_of_char(encoded_string[pos + 0])) << 2) +
-                                                           ((pos_of_char_1 & 0x30) >> 4)));
+        *out++ = static_cast<std::string::value_type>(((pos_of_char(encoded_string[pos + 0])) << 2) +
+                                                      ((pos_of_char_1 & 0x30) >> 4));
 
         if ((pos + 2 <
              length_of_string) && // Check for data that is not padded with equal signs (which is allowed by RFC 2045)
@@ -240,22 +548,23 @@ template <typename String> static std::string decode(String encoded_string, bool
             // Emit a chunk's second byte (which might not be produced in the last chunk).
             //
             unsigned int pos_of_char_2 = pos_of_char(encoded_string[pos + 2]);
-            ret.push_back(
-                static_cast<std::string::value_type>(((pos_of_char_1 & 0x0f) << 4) + ((pos_of_char_2 & 0x3c) >> 2)));
+            *out++ =
+                static_cast<std::string::value_type>(((pos_of_char_1 & 0x0f) << 4) + ((pos_of_char_2 & 0x3c) >> 2));
 
             if ((pos + 3 < length_of_string) && encoded_string[pos + 3] != '=' && encoded_string[pos + 3] != '.')
             {
                 //
                 // Emit a chunk's third byte (which might not be produced in the last chunk).
                 //
-                ret.push_back(static_cast<std::string::value_type>(((pos_of_char_2 & 0x03) << 6) +
-                                                                   pos_of_char(encoded_string[pos + 3])));
+                *out++ = static_cast<std::string::value_type>(((pos_of_char_2 & 0x03) << 6) +
+                                                              pos_of_char(encoded_string[pos + 3]));
             }
         }
 
         pos += 4;
     }
 
+    ret.resize(static_cast<size_t>(out - ret.data()));
     return ret;
 }
 
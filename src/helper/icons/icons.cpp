@@ -1,12 +1,13 @@
 #if defined(__linux__)
 #include "icons.hpp"
+#include <algorithm>
+#include <array>
 #include <dlfcn.h>
 #include <fancy.hpp>
-#include <filesystem>
-#include <fstream>
+#include <fcntl.h>
 #include <helper/base64/base64.hpp>
 #include <optional>
-#include <regex>
+#include <unistd.h>
 
 namespace Soundux::Objects
 {
@@ -43,43 +44,88 @@ namespace Soundux::Objects
     }
     std::optional<int> IconFetcher::getPpid(int pid)
     {
-        std::filesystem::path path("/proc/" + std::to_string(pid));
-        if (std::filesystem::exists(path))
+        auto fd = open(("/proc/" + std::to_string(pid) + "/stat").c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
         {
-            auto statusFile = path / "status";
-            if (std::filesystem::exists(statusFile) && std::filesystem::is_regular_file(statusFile))
-            {
-                static const std::regex pidRegex(R"(PPid:(\ +|\t)(\d+))");
-                std::ifstream statusStream(statusFile);
+            Fancy::fancy.logTime().warning() << "Failed to find ppid of " >> pid << ", process does not exist"
+                                             << std::endl;
+            return std::nullopt;
+        }
 
-                std::string line;
-                std::smatch match;
-                while (std::getline(statusStream, line))
-                {
-                    if (std::regex_search(line, match, pidRegex))
-                    {
-                        if (match[2].matched)
-                        {
-                            return std::stoi(match[2]);
-                        }
-                    }
-                }
+        std::array<char, 512> buffer{};
+        auto length = read(fd, buffer.data(), buffer.size() - 1);
+        close(fd);
 
-                Fancy::fancy.logTime().warning() << "Failed to find ppid of " >> pid << std::endl;
-                return std::nullopt;
-            }
+        //* The format is "pid (comm) state ppid ...", comm may contain spaces and parentheses itself
+        auto *end = buffer.data() + std::max<ssize_t>(length, 0);
+        auto *it = std::find(std::make_reverse_iterator(end), std::make_reverse_iterator(buffer.data()), ')').base();
+
+        if (it == buffer.data() || end - it < 4)
+        {
+            Fancy::fancy.logTime().warning() << "Failed to find ppid of " >> pid << std::endl;
+            return std::nullopt;
         }
 
-        Fancy::fancy.logTime().warning() << "Failed to find ppid of " >> pid << ", process does not exist" << std::endl;
-        return std::nullopt;
+        it += 3;
+
+        int ppid = 0;
+        bool found = false;
+        for (; it != end && *it >= '0' && *it <= '9'; it++)
+        {
+            ppid = ppid * 10 + (*it - '0');
+            found = true;
+        }
+
+        if (!found)
+        {
+            Fancy::fancy.logTime().warning() << "Failed to find ppid of " >> pid << std::endl;
+            return std::nullopt;
+        }
+
+        return ppid;
     }
-    std::optional<std::string> IconFetcher::getIcon(int pid, bool recursive)
+    std::string IconFetcher::getBinary(int pid)
+    {
+        std::array<char, 4096> buffer{};
+        auto length = readlink(("/proc/" + std::to_string(pid) + "/exe").c_str(), buffer.data(), buffer.size());
+
+        if (length <= 0)
+        {
+            //* Processes we can not inspect are at least cached for as long as they live
+            return "pid:" + std::to_string(pid);
+        }
+
+        return std::string(buffer.data(), static_cast<std::size_t>(length));
+    }
+    std::string IconFetcher::getKey(int pid)
     {
-        if (cache.find(pid) != cache.end())
+        auto key = getBinary(pid);
+
+        //* Interpreters and loaders (wine, java, python) share one binary, so the first arguments tell them apart
+        auto fd = open(("/proc/" + std::to_string(pid) + "/cmdline").c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
         {
-            return cache.at(pid);
+            return key;
         }
 
+        std::array<char, 1024> buffer{};
+        auto length = read(fd, buffer.data(), buffer.size());
+        close(fd);
+
+        //* Arguments are separated by null bytes, only argv[0] and argv[1] are used
+        auto *end = buffer.data() + std::max<ssize_t>(length, 0);
+        auto *first = std::find(buffer.data(), end, '\0');
+        auto *second = first != end ? std::find(first + 1, end, '\0') : end;
+
+        key += '\n';
+        key.append(buffer.data(), second);
+
+        return key;
+    }
+    std::optional<std::string> IconFetcher::fetchIcon(int pid)
+    {
+        std::lock_guard lock(fetchMutex);
+
         LibWnck::forceUpdate(screen);
         auto *windows = LibWnck::getScreenWindows(screen);
 
@@ -92,45 +138,83 @@ namespace Soundux::Objects
             {
                 auto *icon = LibWnck::getWindowIcon(window);
 
-                gsize size = 4096;
-                auto *iconBuff = new gchar[size];
+                gsize size = 0;
+                gchar *iconBuff = nullptr;
 
                 GError *error = nullptr;
                 if (gdk_pixbuf_save_to_buffer(icon, &iconBuff, &size, "png", &error, NULL) != TRUE)
                 {
                     Fancy::fancy.logTime().warning() << "Failed to save icon to buffer, error: " << error->message
                                                      << "(" << error->code << ")" << std::endl;
-                    delete[] iconBuff;
+                    g_error_free(error);
                     return std::nullopt;
                 }
 
                 auto base64 = base64_encode(reinterpret_cast<const unsigned char *>(iconBuff), size, false);
-                delete[] iconBuff;
+                g_free(iconBuff);
+
+                return base64;
+            }
+        }
+
+        return std::nullopt;
+    }
+    std::optional<std::string> IconFetcher::getIcon(int pid, bool recursive)
+    {
+        auto key = getKey(pid);
+        auto now = std::chrono::steady_clock::now();
 
-                if (cache.find(pid) == cache.end())
+        {
+            std::lock_guard lock(cacheMutex);
+            if (auto entry = cacheIndex.find(key); entry != cacheIndex.end())
+            {
+                cache.splice(cache.begin(), cache, entry->second);
+
+                //* Windows might show up later on, so misses are retried every once in a while
+                if (entry->second->icon || now - entry->second->fetched < missRetryInterval)
                 {
-                    cache.insert({pid, base64});
+                    return entry->second->icon;
                 }
-
-                return base64;
             }
         }
 
-        if (recursive)
+        auto icon = fetchIcon(pid);
+
+        if (!icon && recursive)
         {
             auto parentProcess = getPpid(pid);
             if (parentProcess)
             {
-                auto recursiveResult = getIcon(*parentProcess, false);
-                if (recursiveResult)
+                icon = fetchIcon(*parentProcess);
+            }
+        }
+
+        {
+            std::lock_guard lock(cacheMutex);
+            if (auto entry = cacheIndex.find(key); entry != cacheIndex.end())
+            {
+                entry->second->icon = icon;
+                entry->second->fetched = now;
+            }
+            else
+            {
+                cache.push_front(Entry{key, icon, now});
+                cacheIndex.emplace(key, cache.begin());
+
+                if (cache.size() > maxCacheSize)
                 {
-                    return recursiveResult;
+                    cacheIndex.erase(cache.back().key);
+                    cache.pop_back();
                 }
             }
         }
 
-        Fancy::fancy.logTime().warning() << "Could not find proccess with id " >> pid << std::endl;
-        return std::nullopt;
+        if (!icon)
+        {
+            Fancy::fancy.logTime().warning() << "Could not find icon for proccess with id " >> pid << std::endl;
+        }
+
+        return icon;
     }
 } // namespace Soundux::Objects
 #endif
\ No newline at end of file
@@ -1,10 +1,13 @@
 #if defined(__linux__)
 #pragma once
 #include "forward.hpp"
-#include <map>
+#include <chrono>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <unordered_map>
 
 namespace Soundux
 {
@@ -12,14 +15,34 @@ namespace Soundux
     {
         class IconFetcher
         {
+            struct Entry
+            {
+                std::string key;
+                std::optional<std::string> icon;
+                std::chrono::steady_clock::time_point fetched;
+            };
+
             LibWnck::Screen *screen;
-            std::map<int, std::string> cache;
+
+            //* Icons are cached per application, most recently used first
+            std::list<Entry> cache;
+            std::unordered_map<std::string, std::list<Entry>::iterator> cacheIndex;
+            std::mutex cacheMutex;
+
+            //* LibWnck is not thread safe, fetches are serialized on their own so that cache hits never wait for them
+            std::mutex fetchMutex;
+
+            static constexpr std::size_t maxCacheSize = 64;
+            static constexpr std::chrono::seconds missRetryInterval{10};
 
           private:
             IconFetcher() = default;
 
             bool setup();
             std::optional<int> getPpid(int pid);
+            std::string getBinary(int pid);
+            std::string getKey(int pid);
+            std::optional<std::string> fetchIcon(int pid);
 
           public:
             static std::shared_ptr<IconFetcher> createInstance();
@@ -27,4 +50,4 @@ namespace Soundux
         };
     } // namespace Objects
 } // namespace Soundux
-#endif
\ No newline at end of file
+#endif
@@ -15,6 +15,16 @@
 
 namespace nlohmann
 {
+    template <> struct adl_serializer<Soundux::Objects::Metadata>
+    {
+        static void to_json(json &j, const Soundux::Objects::Metadata &obj)
+        {
+            j = {
+                {"format", obj.format}, {"sampleRate", obj.sampleRate}, {"channels", obj.channels},
+                {"length", obj.length}, {"lengthInMs", obj.lengthInMs},
+            };
+        }
+    };
     template <> struct adl_serializer<Soundux::Objects::Sound>
     {
         static void to_json(json &j, const Soundux::Objects::Sound &obj)
@@ -46,6 +56,14 @@ namespace nlohmann
             {
                 j["remoteVolume"] = nullptr;
             }
+            if (obj.trimSilence)
+            {
+                j["trimSilence"] = *obj.trimSilence;
+            }
+            else
+            {
+                j["trimSilence"] = nullptr;
+            }
         }
         static void from_json(const json &j, Soundux::Objects::Sound &obj)
         {
@@ -72,6 +90,13 @@ namespace nlohmann
                     obj.remoteVolume = j.at("remoteVolume").get<int>();
                 }
             }
+            if (j.find("trimSilence") != j.end())
+            {
+                if (j.at("trimSilence").is_boolean())
+                {
+                    obj.trimSilence = j.at("trimSilence").get<bool>();
+                }
+            }
         }
     };
     template <> struct adl_serializer<Soundux::Objects::AudioDevice>
@@ -86,28 +111,39 @@ namespace nlohmann
             j.at("isDefault").get_to(obj.isDefault);
         }
     };
+    template <> struct adl_serializer<Soundux::Objects::Levels>
+    {
+        static void to_json(json &j, const Soundux::Objects::Levels &obj)
+        {
+            j = {{"peak", obj.peak}, {"rms", obj.rms}};
+        }
+    };
     template <> struct adl_serializer<Soundux::Objects::PlayingSound>
     {
         static void to_json(json &j, const Soundux::Objects::PlayingSound &obj)
         {
             j = {
-                {"sound", obj.sound},           {"id", obj.id},
-                {"length", obj.length},         {"paused", obj.paused.load()},
-                {"lengthInMs", obj.lengthInMs}, {"repeat", obj.repeat.load()},
-                {"readFrames", obj.readFrames}, {"readInMs", obj.readInMs.load()},
+                {"sound", obj.info->sound},           {"id", obj.id},
+                {"length", obj.info->length},         {"paused", obj.paused},
+                {"lengthInMs", obj.info->lengthInMs}, {"repeat", obj.repeat},
+                {"readFrames", obj.readFrames},       {"readInMs", obj.readInMs},
+                {"peak", obj.peak},                   {"rms", obj.rms},
             };
         }
         static void from_json(const json &j, Soundux::Objects::PlayingSound &obj)
         {
+            auto info = std::make_shared<Soundux::Objects::PlayingSoundInfo>();
+            j.at("sound").get_to(info->sound);
+            j.at("length").get_to(info->length);
+            j.at("lengthInMs").get_to(info->lengthInMs);
+
             j.at("id").get_to(obj.id);
-            j.at("sound").get_to(obj.sound);
-            j.at("length").get_to(obj.length);
+            j.at("paused").get_to(obj.paused);
+            j.at("repeat").get_to(obj.repeat);
+            j.at("readInMs").get_to(obj.readInMs);
             j.at("readFrames").get_to(obj.readFrames);
-            j.at("lengthInMs").get_to(obj.lengthInMs);
 
-            obj.paused.store(j.at("paused").get<bool>());
-            obj.repeat.store(j.at("repeat").get<bool>());
-            obj.readInMs.store(j.at("readInMs").get<std::uint64_t>());
+            obj.info = info;
         }
     };
 
@@ -128,6 +164,15 @@ namespace nlohmann
                 {"remoteVolume", obj.remoteVolume},
                 {"audioBackend", obj.audioBackend},
                 {"deleteToTrash", obj.deleteToTrash},
+                {"trimSilence", obj.trimSilence},
+                {"normalizeLoudness", obj.normalizeLoudness},
+                {"targetLoudness", obj.targetLoudness},
+                {"streamThresholdInMs", obj.streamThresholdInMs},
+                {"streamReadAheadInMs", obj.streamReadAheadInMs},
+                {"routingLingerInMs", obj.routingLingerInMs},
+                {"activationTailInMs", obj.activationTailInMs},
+                {"prepareTtlInMs", obj.prepareTtlInMs},
+                {"preloadBudgetInMb", obj.preloadBudgetInMb},
                 {"pushToTalkKeys", obj.pushToTalkKeys},
                 {"tabHotkeysOnly", obj.tabHotkeysOnly},
                 {"minimizeToTray", obj.minimizeToTray},
@@ -211,6 +256,15 @@ namespace nlohmann
             get_to_safe(j, "audioBackend", obj.audioBackend);
             get_to_safe(j, "remoteVolume", obj.remoteVolume);
             get_to_safe(j, "deleteToTrash", obj.deleteToTrash);
+            get_to_safe(j, "trimSilence", obj.trimSilence);
+            get_to_safe(j, "normalizeLoudness", obj.normalizeLoudness);
+            get_to_safe(j, "targetLoudness", obj.targetLoudness);
+            get_to_safe(j, "streamThresholdInMs", obj.streamThresholdInMs);
+            get_to_safe(j, "streamReadAheadInMs", obj.streamReadAheadInMs);
+            get_to_safe(j, "routingLingerInMs", obj.routingLingerInMs);
+            get_to_safe(j, "activationTailInMs", obj.activationTailInMs);
+            get_to_safe(j, "prepareTtlInMs", obj.prepareTtlInMs);
+            get_to_safe(j, "preloadBudgetInMb", obj.preloadBudgetInMb);
             get_to_safe(j, "pushToTalkKeys", obj.pushToTalkKeys);
             get_to_safe(j, "minimizeToTray", obj.minimizeToTray);
             get_to_safe(j, "tabHotkeysOnly", obj.tabHotkeysOnly);
@@ -270,16 +324,33 @@ namespace nlohmann
             j.at("tabs").get_to(obj.tabs);
         }
     };
+    template <> struct adl_serializer<Soundux::Objects::PlayStatistic>
+    {
+        static void to_json(json &j, const Soundux::Objects::PlayStatistic &obj)
+        {
+            j = {{"count", obj.count}, {"lastPlayed", obj.lastPlayed}, {"score", obj.score}};
+        }
+        static void from_json(const json &j, Soundux::Objects::PlayStatistic &obj)
+        {
+            j.at("count").get_to(obj.count);
+            j.at("lastPlayed").get_to(obj.lastPlayed);
+            j.at("score").get_to(obj.score);
+        }
+    };
     template <> struct adl_serializer<Soundux::Objects::Config>
     {
         static void to_json(json &j, const Soundux::Objects::Config &obj)
         {
-            j = {{"data", obj.data}, {"settings", obj.settings}};
+            j = {{"data", obj.data}, {"settings", obj.settings}, {"statistics", obj.statistics}};
         }
         static void from_json(const json &j, Soundux::Objects::Config &obj)
         {
             j.at("data").get_to(obj.data);
             j.at("settings").get_to(obj.settings);
+            if (j.find("statistics") != j.end())
+            {
+                j.at("statistics").get_to(obj.statistics);
+            }
         }
     };
     template <> struct adl_serializer<Soundux::Objects::VersionStatus>
@@ -0,0 +1,158 @@
+#include "metrics.hpp"
+#include <algorithm>
+#include <cmath>
+#include <core/global/globals.hpp>
+#include <cstdlib>
+#include <fancy.hpp>
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+namespace Soundux::Objects
+{
+    //* Keeps a runaway trace from eating all memory, roughly 32MB worth of events
+    static constexpr std::size_t maxTraceEvents = 1000000;
+
+    Metrics::Metrics() : epoch(std::chrono::steady_clock::now())
+    {
+        if (const auto *path = std::getenv("SOUNDUX_TRACE"); path && *path) // NOLINT
+        {
+            tracePath = path;
+        }
+    }
+
+    void Metrics::record(const char *name, const std::chrono::steady_clock::time_point &start,
+                         const std::chrono::steady_clock::time_point &end)
+    {
+        auto duration =
+            static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+
+        std::size_t bucket = 0;
+        if (duration > 0)
+        {
+            bucket = std::min<std::size_t>(static_cast<std::size_t>(std::log2(duration) * 4) + 1, 127);
+        }
+
+        {
+            auto scoped = histograms.scoped();
+            auto &histogram = (*scoped)[name];
+
+            histogram.count++;
+            histogram.buckets[bucket]++;
+            histogram.max = std::max(histogram.max, duration);
+        }
+
+        if (tracePath)
+        {
+            auto scoped = events.scoped();
+            if (scoped->size() < maxTraceEvents)
+            {
+                auto offset = std::chrono::duration_cast<std::chrono::microseconds>(start - epoch).count();
+                scoped->push_back({name, static_cast<std::uint64_t>(offset), duration,
+                                   std::hash<std::thread::id>{}(std::this_thread::get_id())});
+            }
+        }
+    }
+
+    double Metrics::percentile(const Histogram &histogram, double percentile)
+    {
+        auto rank = static_cast<std::uint64_t>(std::ceil(percentile * static_cast<double>(histogram.count)));
+        std::uint64_t seen = 0;
+
+        for (std::size_t i = 0; histogram.buckets.size() > i; i++)
+        {
+            seen += histogram.buckets[i];
+            if (seen >= rank && seen > 0)
+            {
+                //* Upper bound of the bucket, but never above what we've actually seen
+                auto upper = i == 0 ? 0.0 : std::pow(2.0, static_cast<double>(i) / 4.0);
+                return std::min(upper, static_cast<double>(histogram.max)) / 1000.0;
+            }
+        }
+
+        return static_cast<double>(histogram.max) / 1000.0;
+    }
+
+    void Metrics::count(const char *name, bool hit)
+    {
+        auto scoped = ratios.scoped();
+        auto &ratio = (*scoped)[name];
+
+        if (hit)
+        {
+            ratio.first++;
+        }
+        else
+        {
+            ratio.second++;
+        }
+    }
+    std::vector<MetricSummary> Metrics::getSummaries()
+    {
+        std::vector<MetricSummary> rtn;
+
+        auto scoped = histograms.scoped();
+        for (const auto &[name, histogram] : *scoped)
+        {
+            rtn.push_back({name, histogram.count, percentile(histogram, 0.5), percentile(histogram, 0.99),
+                           static_cast<double>(histogram.max) / 1000.0});
+        }
+
+        return rtn;
+    }
+    std::vector<MetricRatio> Metrics::getRatios()
+    {
+        std::vector<MetricRatio> rtn;
+
+        auto scoped = ratios.scoped();
+        for (const auto &[name, ratio] : *scoped)
+        {
+            auto total = ratio.first + ratio.second;
+            rtn.push_back({name, ratio.first, ratio.second,
+                           total > 0 ? static_cast<double>(ratio.first) / static_cast<double>(total) : 0.0});
+        }
+
+        return rtn;
+    }
+
+    bool Metrics::dumpTrace()
+    {
+        if (!tracePath)
+        {
+            return false;
+        }
+
+        auto trace = nlohmann::json::array();
+        {
+            auto scoped = events.scoped();
+            for (const auto &event : *scoped)
+            {
+                trace.push_back({{"name", event.name},
+                                 {"cat", "soundux"},
+                                 {"ph", "X"},
+                                 {"ts", event.start},
+                                 {"dur", event.duration},
+                                 {"pid", 1},
+                                 {"tid", event.thread}});
+            }
+        }
+
+        std::ofstream file(*tracePath);
+        if (!file.is_open())
+        {
+            Fancy::fancy.logTime().warning() << "Failed to write trace to " << *tracePath << std::endl;
+            return false;
+        }
+
+        file << nlohmann::json{{"traceEvents", trace}, {"displayTimeUnit", "ms"}}.dump();
+        Fancy::fancy.logTime().success() << "Wrote " << trace.size() << " trace events to " << *tracePath
+                                         << std::endl;
+
+        return true;
+    }
+
+    TraceScope::TraceScope(const char *name) : name(name), start(std::chrono::steady_clock::now()) {}
+    TraceScope::~TraceScope()
+    {
+        Globals::gMetrics.record(name, start, std::chrono::steady_clock::now());
+    }
+} // namespace Soundux::Objects
@@ -0,0 +1,89 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <thread>
+#include <var_guard.hpp>
+#include <vector>
+
+namespace Soundux
+{
+    namespace Objects
+    {
+        struct MetricSummary
+        {
+            std::string name;
+            std::uint64_t count;
+
+            //* All in milliseconds
+            double p50;
+            double p99;
+            double max;
+        };
+        struct MetricRatio
+        {
+            std::string name;
+            std::uint64_t hits;
+            std::uint64_t misses;
+            double rate;
+        };
+
+        class Metrics
+        {
+            //* Logarithmic buckets with four buckets per power of two (in microseconds)
+            struct Histogram
+            {
+                std::array<std::uint64_t, 128> buckets{};
+                std::uint64_t count = 0;
+                std::uint64_t max = 0;
+            };
+
+            struct TraceEvent
+            {
+                const char *name;
+                std::uint64_t start;
+                std::uint64_t duration;
+                std::size_t thread;
+            };
+
+            sxl::var_guard<std::map<std::string, Histogram>> histograms;
+            //* Hits and misses, e.g. of a cache
+            sxl::var_guard<std::map<std::string, std::pair<std::uint64_t, std::uint64_t>>> ratios;
+
+            //* Only collected when SOUNDUX_TRACE points to a file
+            std::optional<std::string> tracePath;
+            sxl::var_guard<std::vector<TraceEvent>> events;
+            std::chrono::steady_clock::time_point epoch;
+
+            static double percentile(const Histogram &, double);
+
+          public:
+            Metrics();
+
+            void record(const char *, const std::chrono::steady_clock::time_point &,
+                        const std::chrono::steady_clock::time_point &);
+
+            void count(const char *, bool);
+
+            std::vector<MetricSummary> getSummaries();
+            std::vector<MetricRatio> getRatios();
+            bool dumpTrace();
+        };
+
+        class TraceScope
+        {
+            const char *name;
+            std::chrono::steady_clock::time_point start;
+
+          public:
+            explicit TraceScope(const char *);
+            ~TraceScope();
+
+            TraceScope(const TraceScope &) = delete;
+            TraceScope &operator=(const TraceScope &) = delete;
+        };
+    } // namespace Objects
+} // namespace Soundux
@@ -6,6 +6,7 @@
 #include <core/global/globals.hpp> // Access gConfig
 #include <core/config/config.hpp> // Access Config class directly for save
 #include <fancy.hpp>
+#include <helper/json/bindings.hpp>
 #include <filesystem>
 // #include <fancy.hpp> // Duplicate include removed
 #include <ui/impl/webview/webview.hpp>
@@ -34,6 +35,7 @@ namespace Soundux::Objects
     void saveSettingsImmediately(const std::string& reason) {
         try {
             Globals::gConfig.settings = Globals::gSettings;
+            Globals::gConfig.statistics = Globals::gPreloader.getStatistics();
             Globals::gConfig.data.set(Globals::gData);
             Globals::gConfig.save();
             Fancy::fancy.logTime().message() << "Settings saved immediately (" << reason << ")."; // CHANGED info() to message()
@@ -554,6 +556,26 @@ namespace Soundux::Objects
             res.set_content("{\"status\":\"ok\"}", "application/json");
         });
 
+        // Latency histograms of backend operations
+        server->Get("/api/metrics", [](const httplib::Request &, httplib::Response &res) {
+            try {
+                nlohmann::json jsonArray = nlohmann::json::array();
+                for (const auto &metric : Soundux::Globals::gMetrics.getSummaries()) {
+                    jsonArray.push_back({{"name", metric.name}, {"count", metric.count}, {"p50Ms", metric.p50}, {"p99Ms", metric.p99}, {"maxMs", metric.max}});
+                }
+                res.set_content(jsonArray.dump(), "application/json");
+            } catch (const std::exception &e) { res.status = 500; res.set_content("{\"error\":\"Failed to get metrics: " + std::string(e.what()) + "\"}", "application/json"); }
+        });
+
+        // Hit rates, e.g. of the preloader
+        server->Get("/api/metrics/ratios", [](const httplib::Request &, httplib::Response &res) {
+            nlohmann::json jsonArray = nlohmann::json::array();
+            for (const auto &ratio : Soundux::Globals::gMetrics.getRatios()) {
+                jsonArray.push_back({{"name", ratio.name}, {"hits", ratio.hits}, {"misses", ratio.misses}, {"rate", ratio.rate}});
+            }
+            res.set_content(jsonArray.dump(), "application/json");
+        });
+
         // Toggle global play/pause state
         server->Post("/api/playback/toggle", [](const httplib::Request &req, httplib::Response &res) {
             try {
@@ -655,11 +677,13 @@ namespace Soundux::Objects
                     nlohmann::json jsonSounds = nlohmann::json::array();
                     for (const auto &sound : tab->sounds)
                     {
+                         auto metadata = Soundux::Globals::gMetadata.get(sound);
                          jsonSounds.push_back({
                             {"id", sound.id},
                             {"name", sound.name},
                             {"path", sound.path},
-                            {"isFavorite", sound.isFavorite}
+                            {"isFavorite", sound.isFavorite},
+                            {"metadata", metadata ? nlohmann::json(*metadata) : nlohmann::json(nullptr)}
                          });
                     }
                     res.set_content(jsonSounds.dump(), "application/json");
@@ -717,7 +741,7 @@ namespace Soundux::Objects
                 if (!webview) { res.status = 503; res.set_content("{\"error\":\"Sound playback service not available\"}", "application/json"); return; }
                 auto playingSound = webview->playSoundById(soundId);
                 if (playingSound) {
-                    nlohmann::json response = {{"success", true}, {"id", soundId}, {"playingId", playingSound->id}, {"lengthInMs", playingSound->lengthInMs}, {"length", playingSound->length}, {"sampleRate", playingSound->sampleRate}};
+                    nlohmann::json response = {{"success", true}, {"id", soundId}, {"playingId", playingSound->id}, {"lengthInMs", playingSound->info->lengthInMs}, {"length", playingSound->info->length}, {"sampleRate", playingSound->info->sampleRate}};
                     res.set_content(response.dump(), "application/json");
                 } else {
                     auto soundExists = Soundux::Globals::gData.getSound(soundId).has_value();
@@ -729,6 +753,20 @@ namespace Soundux::Objects
             catch (const std::exception &e) { res.status = 500; res.set_content("{\"error\":\"An unexpected error occurred: " + std::string(e.what()) + "\"}", "application/json"); }
         });
 
+        // Pre-arm a sound on touch-down, a play that follows within prepareTtlInMs starts it without opening anything
+        server->Post(R"(/api/sounds/(\d+)/prepare)", [](const httplib::Request &req, httplib::Response &res) {
+            try {
+                auto soundId = std::stoul(req.matches[1].str());
+                auto* webview = dynamic_cast<Soundux::Objects::WebView*>(Soundux::Globals::gGui.get());
+                if (!webview) { res.status = 503; res.set_content("{\"error\":\"Sound playback service not available\"}", "application/json"); return; }
+                if (!Soundux::Globals::gData.getSound(soundId)) { res.status = 404; res.set_content("{\"error\":\"Sound not found\"}", "application/json"); return; }
+                if (webview->prepareSoundForWeb(soundId)) { res.set_content(nlohmann::json{{"success", true}, {"id", soundId}, {"ttlInMs", Soundux::Globals::gSettings.prepareTtlInMs}}.dump(), "application/json"); }
+                else { res.status = 500; res.set_content("{\"error\":\"Failed to prepare sound\"}", "application/json"); }
+            } catch (const std::invalid_argument &) { res.status = 400; res.set_content("{\"error\":\"Invalid sound ID format\"}", "application/json"); }
+            catch (const std::out_of_range &) { res.status = 400; res.set_content("{\"error\":\"Invalid sound ID value\"}", "application/json"); }
+            catch (const std::exception &e) { res.status = 500; res.set_content("{\"error\":\"An unexpected error occurred: " + std::string(e.what()) + "\"}", "application/json"); }
+        });
+
         // Get progress of currently playing sounds
         server->Get("/api/sounds/progress", [](const httplib::Request &, httplib::Response &res) {
             try {
@@ -736,15 +774,60 @@ namespace Soundux::Objects
                 nlohmann::json jsonArray = nlohmann::json::array();
                 for (const auto &sound : playingSounds) {
                     nlohmann::json soundObj;
-                    soundObj["id"] = sound.id; soundObj["soundId"] = sound.sound.id; soundObj["name"] = sound.sound.name;
-                    soundObj["lengthInMs"] = sound.lengthInMs; soundObj["readInMs"] = sound.readInMs.load(std::memory_order_relaxed);
-                    soundObj["paused"] = sound.paused.load(std::memory_order_relaxed); soundObj["repeat"] = sound.repeat.load(std::memory_order_relaxed);
+                    soundObj["id"] = sound.id; soundObj["soundId"] = sound.info->sound.id; soundObj["name"] = sound.info->sound.name;
+                    soundObj["lengthInMs"] = sound.info->lengthInMs; soundObj["readInMs"] = sound.readInMs;
+                    soundObj["paused"] = sound.paused; soundObj["repeat"] = sound.repeat;
+                    soundObj["peak"] = sound.peak; soundObj["rms"] = sound.rms;
                     jsonArray.push_back(soundObj);
                 }
                 res.set_content(jsonArray.dump(), "application/json");
             } catch (const std::exception &e) { res.status = 500; res.set_content("{\"error\":\"Failed to get sound progress: " + std::string(e.what()) + "\"}", "application/json"); }
         });
 
+        // Output levels of the remote bus, null when sounds are not mixed into one
+        server->Get("/api/sounds/levels", [](const httplib::Request &, httplib::Response &res) {
+            nlohmann::json response = {{"bus", nullptr}};
+            if (auto levels = Soundux::Globals::gAudio.getBusLevels(); levels) { response["bus"] = {{"peak", levels->peak}, {"rms", levels->rms}}; }
+            res.set_content(response.dump(), "application/json");
+        });
+
+        // Seek a playing sound, the id is the one reported by /api/sounds/progress
+        server->Post(R"(/api/sounds/progress/(\d+)/seek)", [](const httplib::Request &req, httplib::Response &res) {
+            try {
+                auto playingId = static_cast<std::uint32_t>(std::stoul(req.matches[1].str()));
+                auto json = nlohmann::json::parse(req.body);
+                auto position = json.value("position", std::uint64_t{0});
+                auto* webview = dynamic_cast<Soundux::Objects::WebView*>(Soundux::Globals::gGui.get());
+                if (!webview) { res.status = 503; res.set_content("{\"error\":\"Playback control service unavailable\"}", "application/json"); return; }
+                auto sound = webview->seekSoundForWeb(playingId, position);
+                if (sound) { res.set_content(nlohmann::json{{"success", true}, {"id", sound->id}, {"readInMs", sound->readInMs}}.dump(), "application/json"); }
+                else { res.status = 404; res.set_content("{\"error\":\"Sound is not playing\"}", "application/json"); }
+            } catch (const nlohmann::json::exception &e) { res.status = 400; res.set_content("{\"error\":\"Invalid JSON request: " + std::string(e.what()) + "\"}", "application/json"); }
+            catch (const std::exception &) { res.status = 400; res.set_content("{\"error\":\"Invalid playing sound ID\"}", "application/json"); }
+        });
+
+        // Min/max overview of a sound, never decoded here: sounds that were not analyzed yet are queued and answered with 202
+        server->Get(R"(/api/sounds/(\d+)/waveform)", [](const httplib::Request &req, httplib::Response &res) {
+            try {
+                auto soundOpt = Soundux::Globals::gData.getSound(std::stoul(req.matches[1].str()));
+                if (!soundOpt) { res.status = 404; res.set_content("{\"error\":\"Sound not found\"}", "application/json"); return; }
+                auto sound = soundOpt->get();
+
+                auto waveform = Soundux::Globals::gAnalyzer.getWaveform(sound);
+                if (!waveform) { Soundux::Globals::gAnalyzer.enqueue(sound); res.status = 202; res.set_content("{\"status\":\"pending\"}", "application/json"); return; }
+
+                std::ostringstream etag; etag << '"' << std::hex << std::hash<std::string>{}(sound.path) << '-' << waveform->modifiedDate << '"';
+                res.set_header("ETag", etag.str()); res.set_header("Cache-Control", "no-cache");
+                if (req.get_header_value("If-None-Match") == etag.str()) { res.status = 304; return; }
+
+                nlohmann::json response = {{"id", sound.id}, {"buckets", Objects::Waveform::buckets}, {"min", waveform->min}, {"max", waveform->max}};
+                if (auto metadata = Soundux::Globals::gMetadata.get(sound); metadata) { response["lengthInMs"] = metadata->lengthInMs; } else { response["lengthInMs"] = nullptr; }
+                res.set_content(response.dump(), "application/json");
+            } catch (const std::invalid_argument &) { res.status = 400; res.set_content("{\"error\":\"Invalid sound ID format\"}", "application/json"); }
+            catch (const std::out_of_range &) { res.status = 400; res.set_content("{\"error\":\"Invalid sound ID value\"}", "application/json"); }
+            catch (const std::exception &e) { res.status = 500; res.set_content("{\"error\":\"Failed to get waveform: " + std::string(e.what()) + "\"}", "application/json"); }
+        });
+
         // Stop all sounds
         server->Post("/api/sounds/stop", [](const httplib::Request &, httplib::Response &res) {
             try {
@@ -763,11 +846,10 @@ namespace Soundux::Objects
                 if (soundOpt) {
                     const Sound& sound = soundOpt->get();
                     std::string tabName = "Unknown"; std::uint32_t tabId = 0;
-                    for (const auto &tab : Soundux::Globals::gData.getTabs()) {
-                        for (const auto &tabSound : tab.sounds) { if (tabSound.id == soundId) { tabName = tab.name; tabId = tab.id; goto found_tab_single; } }
-                    } found_tab_single:;
+                    if (auto location = Soundux::Globals::gData.locateSound(soundId); location) { tabId = location->tabId; tabName = Soundux::Globals::gData.getTabName(tabId).value_or(tabName); }
                     nlohmann::json response;
                     response["id"] = sound.id; response["name"] = sound.name; response["path"] = sound.path; response["isFavorite"] = sound.isFavorite; response["tabName"] = tabName; response["tabId"] = tabId;
+                    auto metadata = Soundux::Globals::gMetadata.get(sound); response["metadata"] = metadata ? nlohmann::json(*metadata) : nlohmann::json(nullptr);
                     int defaultLocalVolume = Soundux::Globals::gSettings.localVolume; int defaultRemoteVolume = Soundux::Globals::gSettings.remoteVolume;
                     response["defaultLocalVolume"] = defaultLocalVolume; response["defaultRemoteVolume"] = defaultRemoteVolume;
                     bool hasCustomLocal = sound.localVolume.has_value(); bool hasCustomRemote = sound.remoteVolume.has_value(); bool hasCustomVolume = hasCustomLocal || hasCustomRemote;
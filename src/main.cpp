@@ -77,9 +77,13 @@ int main(int argc, char **arguments)
         return 1;
     }
 
+    //* Has to happen before the config is loaded, loading it enqueues every sound for analysis
+    gAnalyzer.load();
+    gMetadata.load();
     gConfig.load();
     gData.set(gConfig.data);
     gSettings = gConfig.settings;
+    gPreloader.setStatistics(gConfig.statistics);
 
 #if defined(__linux__)
     gIcons = IconFetcher::createInstance();
@@ -165,12 +169,16 @@ int main(int argc, char **arguments)
         #if defined(__linux__)
         if (gAudioBackend) { gAudioBackend->destroy(); }
         #endif
+        gMetrics.dumpTrace();
+        gAnalyzer.save();
+        gMetadata.save();
 
         Fancy::fancy.logTime().message() << "Attempting final save before exit...";
         try {
             // Use fully qualified names here
             Soundux::Globals::gConfig.data.set(Soundux::Globals::gData);
             Soundux::Globals::gConfig.settings = Soundux::Globals::gSettings;
+            Soundux::Globals::gConfig.statistics = Soundux::Globals::gPreloader.getStatistics();
             Soundux::Globals::gConfig.save();
             Fancy::fancy.logTime().success() << "Final configuration saved successfully.";
         } catch (const std::exception& e) {
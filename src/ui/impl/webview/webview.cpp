@@ -131,7 +131,9 @@ namespace Soundux::Objects
 #endif
         }));
         webview->expose(Webview::Function("addTab", [this]() { return (addTab()); }));
+        webview->expose(Webview::Function("getBusLevels", []() -> nlohmann::json { auto levels = Globals::gAudio.getBusLevels(); if (levels) { return *levels; } return nullptr; }));
         webview->expose(Webview::Function("getTabs", []() { return Globals::gData.getTabs(); }));
+        webview->expose(Webview::Function("getMetadata", [](std::uint32_t tabId) { auto metadata = nlohmann::json::object(); auto tab = Globals::gData.getTab(tabId); if (tab) { for (const auto &sound : tab->sounds) { auto entry = Globals::gMetadata.get(sound); metadata[std::to_string(sound.id)] = entry ? nlohmann::json(*entry) : nlohmann::json(nullptr); } } return metadata; }));
         webview->expose(Webview::Function("playSound", [this](std::uint32_t id) { return playSound(id); }));
         webview->expose(Webview::Function("stopSound", [this](std::uint32_t id) { return stopSound(id); }));
         webview->expose(Webview::Function("seekSound", [this](std::uint32_t id, std::uint64_t seekTo) { return seekSound(id, seekTo); }));
@@ -159,6 +161,7 @@ namespace Soundux::Objects
         webview->expose(Webview::Function("deleteSound", [this](std::uint32_t id) { return deleteSound(id); }));
         webview->expose(Webview::Function("setCustomLocalVolume", [this](const std::uint32_t &id, const std::optional<int> &volume) { auto r = setCustomLocalVolume(id, volume); onSettingsChanged(); return r; }));
         webview->expose(Webview::Function("setCustomRemoteVolume", [this](const std::uint32_t &id, const std::optional<int> &volume) { auto r = setCustomRemoteVolume(id, volume); onSettingsChanged(); return r; }));
+        webview->expose(Webview::Function("setTrimSilence", [this](const std::uint32_t &id, const std::optional<bool> &trimSilence) { auto r = setTrimSilence(id, trimSilence); onSettingsChanged(); return r; }));
         webview->expose(Webview::Function("toggleSoundPlayback", [this]() { return toggleSoundPlayback(); }));
         webview->expose(Webview::Function("getSoundVolumes", []() {
             nlohmann::json response;
@@ -476,7 +479,7 @@ namespace Soundux::Objects
             return true;
         }
         Fancy::fancy.logTime().message() << "Window closing, saving configuration..." << std::endl;
-        try { Soundux::Globals::gConfig.data.set(Soundux::Globals::gData); Soundux::Globals::gConfig.settings = Soundux::Globals::gSettings; Soundux::Globals::gConfig.save(); Fancy::fancy.logTime().success() << "Configuration saved on close." << std::endl; }
+        try { Soundux::Globals::gConfig.data.set(Soundux::Globals::gData); Soundux::Globals::gConfig.settings = Soundux::Globals::gSettings; Soundux::Globals::gConfig.statistics = Soundux::Globals::gPreloader.getStatistics(); Soundux::Globals::gConfig.save(); Fancy::fancy.logTime().success() << "Configuration saved on close." << std::endl; }
         catch(const std::exception& e) { Fancy::fancy.logTime().failure() << "Error saving configuration on close: " << e.what() << std::endl; }
         return false;
     }
@@ -650,7 +653,7 @@ namespace Soundux::Objects
         struct TrayGuard { std::shared_ptr<Tray::Tray> trayRef; TrayGuard(std::shared_ptr<Tray::Tray> t) : trayRef(t) {} ~TrayGuard() { if (trayRef) { try { trayRef->exit(); } catch (...) {} } } } trayGuard(tray);
         webview->run();
         Fancy::fancy.logTime().message() << "Saving configuration before final exit..." << std::endl;
-        try { Soundux::Globals::gConfig.data.set(Soundux::Globals::gData); Soundux::Globals::gConfig.settings = Soundux::Globals::gSettings; Soundux::Globals::gConfig.save(); Fancy::fancy.logTime().success() << "Final configuration saved." << std::endl; }
+        try { Soundux::Globals::gConfig.data.set(Soundux::Globals::gData); Soundux::Globals::gConfig.settings = Soundux::Globals::gSettings; Soundux::Globals::gConfig.statistics = Soundux::Globals::gPreloader.getStatistics(); Soundux::Globals::gConfig.save(); Fancy::fancy.logTime().success() << "Final configuration saved." << std::endl; }
         catch(const std::exception& e) { Fancy::fancy.logTime().failure() << "Error saving final configuration: " << e.what() << std::endl; }
         Fancy::fancy.logTime().message() << "WebView main loop finished." << std::endl;
     }
@@ -663,6 +666,7 @@ namespace Soundux::Objects
         }std::string seq; if (!keys.empty()){ for(size_t i=0; i<keys.size(); ++i){ seq += Globals::gHotKeys.getKeyName(keys[i]); if (i < keys.size() - 1) seq += " + "; }} else {seq = "None";} webview->callFunction<void>(Webview::JavaScriptFunction("window.hotkeyReceived", seq, keys)); }
     void WebView::onSoundFinished(const PlayingSound &sound) { if (!webview) return; Window::onSoundFinished(sound); webview->callFunction<void>(Webview::JavaScriptFunction("window.finishSound", sound)); }
     void WebView::onSoundPlayed(const PlayingSound &sound) { if (!webview) return; webview->callFunction<void>(Webview::JavaScriptFunction("window.onSoundPlayed", sound)); }
+    void WebView::onMetadataIndexed() { if (!webview) return; Window::onMetadataIndexed(); webview->callFunction<void>(Webview::JavaScriptFunction("window.getStore().commit", "setTabs", Globals::gData.getTabs())); }
     void WebView::onSoundProgressed(const PlayingSound &sound) { if (!webview) return; webview->callFunction<void>(Webview::JavaScriptFunction("window.updateSound", sound)); }
     void WebView::onDownloadProgressed(float progress, const std::string &eta) { if (!webview) return; webview->callFunction<void>(Webview::JavaScriptFunction("window.downloadProgressed", progress, eta)); }
     void WebView::onError(const Soundux::Enums::ErrorCode &error) { if (!webview) return; webview->callFunction<void>(Webview::JavaScriptFunction("window.onError", static_cast<std::uint8_t>(error))); }
@@ -678,6 +682,8 @@ namespace Soundux::Objects
     std::optional<Sound> WebView::setCustomLocalVolumeForWeb(const std::uint32_t &id, const std::optional<int> &volume) { auto r = setCustomLocalVolume(id, volume); if (r && webview) { onSettingsChanged(); } return r; }
     std::optional<Sound> WebView::setCustomRemoteVolumeForWeb(const std::uint32_t &id, const std::optional<int> &volume) { auto r = setCustomRemoteVolume(id, volume); if (r && webview) { onSettingsChanged(); } return r; }
     bool WebView::toggleFavoriteForWeb(const std::uint32_t &id) { auto s = Globals::gData.getSound(id); if (s){ bool n = !s->get().isFavorite; Globals::gData.markFavorite(id, n); if (webview) { auto f = Globals::gData.getFavoriteIds(); webview->callFunction<void>(Webview::JavaScriptFunction("window.getStore().commit", "setFavorites", f)); } return true; } return false; }
+    std::optional<PlayingSound> WebView::seekSoundForWeb(const std::uint32_t &id, std::uint64_t position) { return seekSound(id, position); }
+    bool WebView::prepareSoundForWeb(const std::uint32_t &id) { return prepareSound(id); }
 
     // --- PIN Display Methods ---
 
@@ -74,6 +74,7 @@ namespace Soundux
             void onSwitchOnConnectDetected(bool state) override;
             void onError(const Soundux::Enums::ErrorCode &error) override;
             void onSoundPlayed(const PlayingSound &sound) override;
+            void onMetadataIndexed() override;
             void onSoundProgressed(const PlayingSound &sound) override;
             void onDownloadProgressed(float progress, const std::string &eta) override;
             void stopAllSounds();
@@ -81,6 +82,8 @@ namespace Soundux
             std::optional<Sound> setCustomLocalVolumeForWeb(const std::uint32_t &id, const std::optional<int> &volume);
             std::optional<Sound> setCustomRemoteVolumeForWeb(const std::uint32_t &id, const std::optional<int> &volume);
             bool toggleFavoriteForWeb(const std::uint32_t &id);
+            std::optional<PlayingSound> seekSoundForWeb(const std::uint32_t &id, std::uint64_t position);
+            bool prepareSoundForWeb(const std::uint32_t &id);
             void setWebRemotePin(const std::string& pin);
 
             std::string toggleAllPlaybackState(); // Returns "paused" or "playing"
@@ -88,6 +88,7 @@ namespace Soundux::Objects
                     sound.isFavorite = oldSound->isFavorite;
                     sound.localVolume = oldSound->localVolume;
                     sound.remoteVolume = oldSound->remoteVolume;
+                    sound.trimSilence = oldSound->trimSilence;
                 }
                 else
                 {
@@ -97,27 +98,7 @@ namespace Soundux::Objects
                 rtn.emplace_back(sound);
             }
 
-            switch (tab.sortMode)
-            {
-            case Enums::SortMode::ModifiedDate_Descending:
-                std::sort(rtn.begin(), rtn.end(), [](const auto &first, const auto &second) {
-                    return first.modifiedDate > second.modifiedDate;
-                });
-                break;
-            case Enums::SortMode::ModifiedDate_Ascending:
-                std::sort(rtn.begin(), rtn.end(), [](const auto &first, const auto &second) {
-                    return first.modifiedDate < second.modifiedDate;
-                });
-                break;
-            case Enums::SortMode::Alphabetical_Descending:
-                std::sort(rtn.begin(), rtn.end(),
-                          [](const auto &first, const auto &second) { return first.name > second.name; });
-                break;
-            case Enums::SortMode::Alphabetical_Ascending:
-                std::sort(rtn.begin(), rtn.end(),
-                          [](const auto &first, const auto &second) { return first.name < second.name; });
-                break;
-            }
+            sortSounds(rtn, tab.sortMode);
 
             return rtn;
         }
@@ -125,6 +106,56 @@ namespace Soundux::Objects
         Fancy::fancy.logTime().warning() << "Path " >> tab.path << " does not exist" << std::endl;
         return {};
     }
+    void Window::sortSounds(std::vector<Sound> &sounds, Enums::SortMode sortMode)
+    {
+        switch (sortMode)
+        {
+        case Enums::SortMode::ModifiedDate_Descending:
+            std::sort(sounds.begin(), sounds.end(), [](const auto &first, const auto &second) {
+                return first.modifiedDate > second.modifiedDate;
+            });
+            break;
+        case Enums::SortMode::ModifiedDate_Ascending:
+            std::sort(sounds.begin(), sounds.end(), [](const auto &first, const auto &second) {
+                return first.modifiedDate < second.modifiedDate;
+            });
+            break;
+        case Enums::SortMode::Alphabetical_Descending:
+            std::sort(sounds.begin(), sounds.end(),
+                      [](const auto &first, const auto &second) { return first.name > second.name; });
+            break;
+        case Enums::SortMode::Alphabetical_Ascending:
+            std::sort(sounds.begin(), sounds.end(),
+                      [](const auto &first, const auto &second) { return first.name < second.name; });
+            break;
+        case Enums::SortMode::Length_Descending:
+        case Enums::SortMode::Length_Ascending: {
+            //* Sounds that are not indexed yet are put last and probed in the background, see onMetadataIndexed
+            std::map<std::uint32_t, std::uint64_t> lengths;
+            for (const auto &sound : sounds)
+            {
+                auto metadata = Globals::gMetadata.get(sound);
+                if (!metadata)
+                {
+                    Globals::gMetadata.enqueue(sound);
+                }
+                lengths.emplace(sound.id, metadata ? metadata->lengthInMs : 0);
+            }
+
+            auto descending = sortMode == Enums::SortMode::Length_Descending;
+            std::stable_sort(sounds.begin(), sounds.end(), [&](const auto &first, const auto &second) {
+                auto firstLength = lengths.at(first.id);
+                auto secondLength = lengths.at(second.id);
+                if (firstLength == 0 || secondLength == 0)
+                {
+                    return firstLength > secondLength;
+                }
+                return descending ? firstLength > secondLength : firstLength < secondLength;
+            });
+            break;
+        }
+        }
+    }
     std::vector<Tab> Window::addTab()
     {
 #if defined(_WIN32)
@@ -209,25 +240,12 @@ namespace Soundux::Objects
         auto sound = Globals::gData.getSound(id);
         if (sound)
         {
+            Globals::gPreloader.onPlayed(id);
+
             if (!Globals::gSettings.allowOverlapping)
             {
                 stopSounds(true);
             }
-            if (Globals::gSettings.muteDuringPlayback)
-            {
-                if (Globals::gAudioBackend)
-                {
-                    if (!Globals::gAudioBackend->muteInput(true))
-                    {
-                        onError(Enums::ErrorCode::FailedToMute);
-                    }
-                }
-            }
-            if (!Globals::gSettings.pushToTalkKeys.empty())
-            {
-                Globals::gHotKeys.pressKeys(Globals::gSettings.pushToTalkKeys);
-            }
-
             auto playingSound = Globals::gAudio.play(*sound);
             auto remotePlayingSound = Globals::gAudio.play(*sound, Globals::gAudio.nullSink);
 
@@ -240,16 +258,8 @@ namespace Soundux::Objects
                 }
                 if (!Globals::gSettings.outputs.empty() && Globals::gAudioBackend)
                 {
-                    bool moveSuccess = false;
-                    for (const auto &outputApp : Globals::gSettings.outputs)
-                    {
-                        if (Globals::gAudioBackend->inputSoundTo(Globals::gAudioBackend->getRecordingApp(outputApp)))
-                        {
-                            moveSuccess = true;
-                        }
-                    }
-
-                    if (!moveSuccess)
+                    //* The router keeps the output apps routed between sounds, so usually there is nothing left to do
+                    if (!Globals::gRouter.acquire())
                     {
                         if (playingSound)
                             stopSound(playingSound->id);
@@ -275,31 +285,37 @@ namespace Soundux::Objects
         onError(Enums::ErrorCode::FailedToPlay);
         return std::nullopt;
     }
+    bool Window::prepareSound(const std::uint32_t &id)
+    {
+        auto sound = Globals::gData.getSound(id);
+        if (!sound)
+        {
+            Fancy::fancy.logTime().warning() << "Sound " << id << " not found" << std::endl;
+            return false;
+        }
+
+        auto prepared = Globals::gAudio.prepare(*sound);
+        prepared = Globals::gAudio.prepare(*sound, Globals::gAudio.nullSink) && prepared;
+
+        if (!Globals::gSettings.outputs.empty() && Globals::gAudioBackend)
+        {
+            Globals::gRouter.prime();
+        }
+
+        return prepared;
+    }
 #else
     std::optional<PlayingSound> Window::playSound(const std::uint32_t &id)
     {
         auto sound = Globals::gData.getSound(id);
         if (sound)
         {
+            Globals::gPreloader.onPlayed(id);
+
             if (!Globals::gSettings.allowOverlapping)
             {
                 stopSounds();
             }
-            if (Globals::gSettings.muteDuringPlayback)
-            {
-                if (Globals::gWinSound && Globals::gWinSound->getMic())
-                {
-                    if (!Globals::gWinSound->getMic()->mute(true))
-                    {
-                        onError(Enums::ErrorCode::FailedToMute);
-                    }
-                }
-            }
-            if (!Globals::gSettings.pushToTalkKeys.empty())
-            {
-                Globals::gHotKeys.pressKeys(Globals::gSettings.pushToTalkKeys);
-            }
-
             if (Globals::gSettings.outputs.empty() && !Globals::gSettings.useAsDefaultDevice)
             {
                 return Globals::gAudio.play(*sound);
@@ -335,6 +351,29 @@ namespace Soundux::Objects
         onError(Enums::ErrorCode::SoundNotFound);
         return std::nullopt;
     }
+    bool Window::prepareSound(const std::uint32_t &id)
+    {
+        auto sound = Globals::gData.getSound(id);
+        if (!sound)
+        {
+            Fancy::fancy.logTime().warning() << "Sound " << id << " not found" << std::endl;
+            return false;
+        }
+
+        auto prepared = Globals::gAudio.prepare(*sound);
+        if (Globals::gSettings.outputs.empty())
+        {
+            return prepared;
+        }
+
+        auto playbackDevice = Globals::gAudio.getAudioDevice(Globals::gSettings.outputs.front());
+        if (playbackDevice && !playbackDevice->isDefault)
+        {
+            prepared = Globals::gAudio.prepare(*sound, playbackDevice) && prepared;
+        }
+
+        return prepared;
+    }
 #endif
     std::optional<PlayingSound> Window::pauseSound(const std::uint32_t &id)
     {
@@ -496,7 +535,7 @@ namespace Soundux::Objects
             groupedSounds->erase(id);
         }
 
-        if (Globals::gAudio.getPlayingSounds().empty())
+        if (!Globals::gActivation.isActive())
         {
             onAllSoundsFinished();
         }
@@ -520,10 +559,6 @@ namespace Soundux::Objects
 #if defined(__linux__)
         if (Globals::gAudioBackend)
         {
-            if (!Globals::gAudioBackend->stopSoundInput())
-            {
-                onError(Enums::ErrorCode::FailedToMoveBack);
-            }
             if (!Globals::gAudioBackend->stopAllPassthrough())
             {
                 onError(Enums::ErrorCode::FailedToMoveBackPassthrough);
@@ -538,12 +573,13 @@ namespace Soundux::Objects
         {
             sound->get().localVolume = localVolume;
 
-            for (auto &playingSound : Globals::gAudio.getPlayingSounds())
+            for (const auto &playingSound : Globals::gAudio.getPlayingSounds())
             {
-                if (playingSound.sound.id == sound->get().id && playingSound.playbackDevice.isDefault)
+                if (playingSound.info->sound.id == sound->get().id && playingSound.info->playbackDevice.isDefault)
                 {
-                    playingSound.raw.device.load()->masterVolumeFactor =
-                        static_cast<float>(localVolume ? *localVolume : Globals::gSettings.localVolume) / 100.f;
+                    Globals::gAudio.setVolume(
+                        playingSound.id,
+                        static_cast<float>(localVolume ? *localVolume : Globals::gSettings.localVolume) / 100.f);
                 }
             }
 
@@ -562,12 +598,13 @@ namespace Soundux::Objects
         {
             sound->get().remoteVolume = remoteVolume;
 
-            for (auto &playingSound : Globals::gAudio.getPlayingSounds())
+            for (const auto &playingSound : Globals::gAudio.getPlayingSounds())
             {
-                if (playingSound.sound.id == sound->get().id && !playingSound.playbackDevice.isDefault)
+                if (playingSound.info->sound.id == sound->get().id && !playingSound.info->playbackDevice.isDefault)
                 {
-                    playingSound.raw.device.load()->masterVolumeFactor =
-                        static_cast<float>(remoteVolume ? *remoteVolume : Globals::gSettings.remoteVolume) / 100.f;
+                    Globals::gAudio.setVolume(
+                        playingSound.id,
+                        static_cast<float>(remoteVolume ? *remoteVolume : Globals::gSettings.remoteVolume) / 100.f);
                 }
             }
 
@@ -579,6 +616,21 @@ namespace Soundux::Objects
         onError(Enums::ErrorCode::FailedToSetCustomVolume);
         return std::nullopt;
     }
+    std::optional<Sound> Window::setTrimSilence(const std::uint32_t &id, const std::optional<bool> &trimSilence)
+    {
+        auto sound = Globals::gData.getSound(id);
+        if (sound)
+        {
+            //* Only affects the next playback, sounds that are already playing keep their offset
+            sound->get().trimSilence = trimSilence;
+            return *sound;
+        }
+
+        Fancy::fancy.logTime().failure() << "Failed to set trim silence for sound " << id << ", sound does not exist"
+                                         << std::endl;
+        onError(Enums::ErrorCode::SoundNotFound);
+        return std::nullopt;
+    }
     Settings Window::changeSettings(Settings settings)
     {
         auto oldSettings = Globals::gSettings;
@@ -590,9 +642,9 @@ namespace Soundux::Objects
             for (const auto &playingSound : Globals::gAudio.getPlayingSounds())
             {
                 int newVolume = 0;
-                const auto &sound = playingSound.sound;
+                const auto &sound = playingSound.info->sound;
 
-                if (playingSound.playbackDevice.isDefault)
+                if (playingSound.info->playbackDevice.isDefault)
                 {
                     newVolume = sound.localVolume ? *sound.localVolume : Globals::gSettings.localVolume;
                 }
@@ -601,9 +653,14 @@ namespace Soundux::Objects
                     newVolume = sound.remoteVolume ? *sound.remoteVolume : Globals::gSettings.remoteVolume;
                 }
 
-                playingSound.raw.device.load()->masterVolumeFactor = static_cast<float>(newVolume) / 100.f;
+                Globals::gAudio.setVolume(playingSound.id, static_cast<float>(newVolume) / 100.f);
             }
         }
+        if (settings.selectedTab != oldSettings.selectedTab ||
+            settings.preloadBudgetInMb != oldSettings.preloadBudgetInMb)
+        {
+            Globals::gPreloader.update();
+        }
 
 #if defined(__linux__)
         if (settings.audioBackend != oldSettings.audioBackend)
@@ -615,12 +672,13 @@ namespace Soundux::Objects
                 Globals::gAudioBackend->destroy();
             }
 
+            Globals::gRouter.reset();
             Globals::gAudioBackend = AudioBackend::createInstance(settings.audioBackend);
             Globals::gAudio.setup();
         }
         if (Globals::gAudioBackend)
         {
-            if (!Globals::gAudio.getPlayingSounds().empty())
+            if (Globals::gActivation.isActive())
             {
                 if (settings.muteDuringPlayback && !oldSettings.muteDuringPlayback)
                 {
@@ -647,7 +705,7 @@ namespace Soundux::Objects
             else if (settings.useAsDefaultDevice && !oldSettings.useAsDefaultDevice)
             {
                 Globals::gSettings.outputs.clear();
-                if (!Globals::gAudioBackend->stopSoundInput())
+                if (!Globals::gRouter.clear())
                 {
                     onError(Enums::ErrorCode::FailedToMoveBack);
                 }
@@ -667,27 +725,17 @@ namespace Soundux::Objects
                     settings.outputs = {settings.outputs.front()};
                 }
 
-                if (!Globals::gAudioBackend->stopSoundInput())
+                Globals::gSettings.outputs = settings.outputs;
+                if (!Globals::gRouter.update() && !settings.outputs.empty())
                 {
-                    onError(Enums::ErrorCode::FailedToMoveBack);
-                }
-
-                for (const auto &outputApp : settings.outputs)
-                {
-                    if (!settings.outputs.empty() && !Globals::gAudio.getPlayingSounds().empty())
-                    {
-                        if (!Globals::gAudioBackend->inputSoundTo(Globals::gAudioBackend->getRecordingApp(outputApp)))
-                        {
-                            onError(Enums::ErrorCode::FailedToMoveToSink);
-                        }
-                    }
+                    onError(Enums::ErrorCode::FailedToMoveToSink);
                 }
             }
         }
 #elif defined(_WIN32)
         if (Globals::gWinSound)
         {
-            if (!Globals::gAudio.getPlayingSounds().empty())
+            if (Globals::gActivation.isActive())
             {
                 if (settings.muteDuringPlayback && !oldSettings.muteDuringPlayback)
                 {
@@ -873,13 +921,10 @@ namespace Soundux::Objects
         bool success = true;
         if (Globals::gAudioBackend && !Globals::gSettings.outputs.empty())
         {
-            for (const auto &outputApp : Globals::gSettings.outputs)
+            if (!Globals::gRouter.acquire())
             {
-                if (!Globals::gAudioBackend->inputSoundTo(Globals::gAudioBackend->getRecordingApp(outputApp)))
-                {
-                    onError(Enums::ErrorCode::FailedToMoveToSink);
-                    success = false;
-                }
+                onError(Enums::ErrorCode::FailedToMoveToSink);
+                success = false;
             }
 
             if (success)
@@ -902,13 +947,10 @@ namespace Soundux::Objects
     {
         if (Globals::gAudioBackend)
         {
-            if (Globals::gAudio.getPlayingSounds().empty() &&
+            if (!Globals::gActivation.isActive() &&
                 Globals::gAudioBackend->currentlyPassedThrough().size() == 1)
             {
-                if (!Globals::gAudioBackend->stopSoundInput())
-                {
-                    onError(Enums::ErrorCode::FailedToMoveBack);
-                }
+                Globals::gRouter.release();
             }
 
             if (!Globals::gAudioBackend->stopPassthrough(name))
@@ -932,54 +974,31 @@ namespace Soundux::Objects
         }
         scoped.unlock();
 
-        if (Globals::gAudio.getPlayingSounds().size() == 1)
+        if (!Globals::gActivation.isActive())
         {
             onAllSoundsFinished();
         }
     }
     void Window::onAllSoundsFinished()
     {
-        if (!Globals::gSettings.pushToTalkKeys.empty())
-        {
-            Globals::gHotKeys.releaseKeys(Globals::gSettings.pushToTalkKeys);
-        }
-
+        //* Muting and push to talk are released by the activation controller once the last voice is gone
 #if defined(__linux__)
-        if (Globals::gAudioBackend)
+        if (Globals::gAudioBackend && Globals::gAudioBackend->currentlyPassedThrough().empty())
         {
-            if (Globals::gSettings.muteDuringPlayback)
-            {
-                if (!Globals::gAudioBackend->muteInput(false))
-                {
-                    onError(Enums::ErrorCode::FailedToMute);
-                }
-            }
-            if (Globals::gAudioBackend->currentlyPassedThrough().empty())
-            {
-                if (!Globals::gAudioBackend->stopSoundInput())
-                {
-                    onError(Enums::ErrorCode::FailedToMoveBack);
-                }
-            }
-        }
-#elif defined(_WIN32)
-        if (Globals::gSettings.muteDuringPlayback)
-        {
-            if (Globals::gWinSound && Globals::gWinSound->getMic())
-            {
-                if (!Globals::gWinSound->getMic()->mute(false))
-                {
-                    onError(Enums::ErrorCode::FailedToMute);
-                }
-            }
+            Globals::gRouter.release();
         }
 #endif
     }
-    void Window::onSoundPlayed([[maybe_unused]] const PlayingSound &sound)
+    void Window::onSoundPlayed([[maybe_unused]] const PlayingSound &sound) {}
+    void Window::onMetadataIndexed()
     {
-        if (!Globals::gSettings.pushToTalkKeys.empty())
+        for (auto &tab : Globals::gData.getTabs())
         {
-            Globals::gHotKeys.pressKeys(Globals::gSettings.pushToTalkKeys);
+            if (tab.sortMode == Enums::SortMode::Length_Ascending || tab.sortMode == Enums::SortMode::Length_Descending)
+            {
+                sortSounds(tab.sounds, tab.sortMode);
+                Globals::gData.setTab(tab.id, tab);
+            }
         }
     }
     void Window::setIsOnFavorites(bool state)
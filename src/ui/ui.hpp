@@ -51,6 +51,7 @@ namespace Soundux
 
           protected:
             virtual std::vector<Sound> getTabContent(const Tab &) const;
+            static void sortSounds(std::vector<Sound> &, Enums::SortMode);
 
 #if defined(__linux__)
             virtual std::vector<std::shared_ptr<IconRecordingApp>> getOutputs();
@@ -83,6 +84,8 @@ namespace Soundux
 
           protected:
             virtual std::optional<PlayingSound> playSound(const std::uint32_t &);
+            //* Gets everything ready for playSound, used by the remote between touch-down and touch-up
+            virtual bool prepareSound(const std::uint32_t &);
             virtual std::optional<PlayingSound> pauseSound(const std::uint32_t &);
             virtual std::optional<PlayingSound> resumeSound(const std::uint32_t &);
             virtual std::optional<PlayingSound> repeatSound(const std::uint32_t &, bool);
@@ -91,6 +94,7 @@ namespace Soundux
             virtual std::optional<Sound> setHotkey(const std::uint32_t &, const std::vector<int> &);
             virtual std::optional<Sound> setCustomLocalVolume(const std::uint32_t &, const std::optional<int> &);
             virtual std::optional<Sound> setCustomRemoteVolume(const std::uint32_t &, const std::optional<int> &);
+            virtual std::optional<Sound> setTrimSilence(const std::uint32_t &, const std::optional<bool> &);
 
           public:
             virtual ~Window();
@@ -102,6 +106,7 @@ namespace Soundux
             virtual void onSettingsChanged() = 0;
             virtual void onSwitchOnConnectDetected(bool) = 0;
             virtual void onSoundPlayed(const PlayingSound &);
+            virtual void onMetadataIndexed();
             virtual void onError(const Enums::ErrorCode &) = 0;
             virtual void onSoundFinished(const PlayingSound &);
             virtual void onHotKeyReceived(const std::vector<int> &);
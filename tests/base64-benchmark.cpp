@@ -0,0 +1,94 @@
+#include <helper/base64/base64.cpp>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+//* Compares the throughput of the scalar and the vectorized base64 paths
+
+namespace
+{
+    constexpr std::size_t size = 16 * 1024 * 1024;
+    constexpr int rounds = 10;
+
+    template <typename Function> double throughput(Function &&function)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; rounds > i; i++)
+        {
+            function();
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        return static_cast<double>(size) * rounds / elapsed.count() / (1024 * 1024);
+    }
+
+    std::size_t decodeScalar(const std::string &encoded, std::size_t length, char *out)
+    {
+        const auto *begin = out;
+        for (std::size_t pos = 0; length > pos; pos += 4)
+        {
+            auto a = pos_of_char(encoded[pos]), b = pos_of_char(encoded[pos + 1]), c = pos_of_char(encoded[pos + 2]),
+                 d = pos_of_char(encoded[pos + 3]);
+
+            *out++ = static_cast<char>((a << 2) + ((b & 0x30) >> 4));
+            *out++ = static_cast<char>(((b & 0x0f) << 4) + ((c & 0x3c) >> 2));
+            *out++ = static_cast<char>(((c & 0x03) << 6) + d);
+        }
+        return static_cast<std::size_t>(out - begin);
+    }
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(0x5d);
+    std::uniform_int_distribution<int> byte(0, 255);
+
+    std::vector<unsigned char> input(size);
+    for (auto &item : input)
+    {
+        item = static_cast<unsigned char>(byte(rng));
+    }
+
+    std::string encoded((size + 2) / 3 * 4, '\0');
+    std::string decoded(size + 32, '\0');
+
+    std::cout << "encode scalar: " << throughput([&] {
+        encode_scalar(input.data(), input.size(), encoded.data(), base64_chars[0], '=');
+    }) << " MB/s" << std::endl;
+
+    //* The buffers are full sized, so this is the last block that is fully valid
+    const auto length = size / 3 * 4;
+
+    std::cout << "decode scalar: " << throughput([&] { decodeScalar(encoded, length, decoded.data()); })
+              << " MB/s" << std::endl;
+
+#if defined(BASE64_X86)
+    const auto cpu = detect_cpu();
+    const std::pair<const char *, bool> paths[] = {{"ssse3", cpu.ssse3}, {"avx2", cpu.avx2}};
+
+    for (const auto &[name, supported] : paths)
+    {
+        if (!supported)
+        {
+            std::cout << name << ": not supported" << std::endl;
+            continue;
+        }
+
+        auto encode = std::string(name) == "avx2" ? encode_avx2 : encode_ssse3;
+        auto decode = std::string(name) == "avx2" ? decode_avx2 : decode_ssse3;
+
+        std::cout << "encode " << name << ": " << throughput([&] {
+            encode(input.data(), input.size(), encoded.data(), base64_chars[0]);
+        }) << " MB/s" << std::endl;
+
+        std::cout << "decode " << name << ": " << throughput([&] {
+            decode(reinterpret_cast<const unsigned char *>(encoded.data()), length, decoded.data());
+        }) << " MB/s" << std::endl;
+    }
+#endif
+
+    std::cout << "base64_decode: " << throughput([&] { base64_decode(encoded); }) << " MB/s" << std::endl;
+
+    return 0;
+}
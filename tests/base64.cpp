@@ -0,0 +1,209 @@
+#include <helper/base64/base64.cpp>
+#include <iostream>
+#include <random>
+#include <vector>
+
+//* Checks every vectorized base64 path the CPU supports against the scalar code
+
+namespace
+{
+    struct Encoder
+    {
+        const char *name;
+        encode_fn function;
+    };
+    struct Decoder
+    {
+        const char *name;
+        decode_fn function;
+    };
+
+    int failures = 0;
+
+    void fail(const std::string &what)
+    {
+        failures++;
+        std::cerr << "FAIL: " << what << std::endl;
+    }
+
+    std::vector<Encoder> encoders()
+    {
+        std::vector<Encoder> rtn;
+#if defined(BASE64_X86)
+        const auto cpu = detect_cpu();
+        if (cpu.ssse3)
+        {
+            rtn.push_back({"ssse3", encode_ssse3});
+        }
+        if (cpu.avx2)
+        {
+            rtn.push_back({"avx2", encode_avx2});
+        }
+#endif
+        return rtn;
+    }
+
+    std::vector<Decoder> decoders()
+    {
+        std::vector<Decoder> rtn;
+#if defined(BASE64_X86)
+        const auto cpu = detect_cpu();
+        if (cpu.ssse3)
+        {
+            rtn.push_back({"ssse3", decode_ssse3});
+        }
+        if (cpu.avx2)
+        {
+            rtn.push_back({"avx2", decode_avx2});
+        }
+#endif
+        return rtn;
+    }
+
+    std::string scalarEncode(const std::vector<unsigned char> &input, bool url)
+    {
+        std::string rtn((input.size() + 2) / 3 * 4, '\0');
+        encode_scalar(input.data(), input.size(), rtn.data(), base64_chars[url], url ? '.' : '=');
+        return rtn;
+    }
+
+    void checkEncoders(const std::vector<unsigned char> &input, bool url)
+    {
+        const auto expected = scalarEncode(input, url);
+
+        for (const auto &encoder : encoders())
+        {
+            std::string result(expected.size(), '\0');
+            auto pos = encoder.function(input.data(), input.size(), result.data(), base64_chars[url]);
+            encode_scalar(input.data() + pos, input.size() - pos, result.data() + pos / 3 * 4, base64_chars[url],
+                          url ? '.' : '=');
+
+            if (result != expected)
+            {
+                fail(std::string(encoder.name) + " encoder, length " + std::to_string(input.size()));
+            }
+        }
+    }
+
+    void checkDecoders(const std::string &encoded, const std::vector<unsigned char> &expected)
+    {
+        for (const auto &decoder : decoders())
+        {
+            //* The decoders may write a whole register past the decoded bytes
+            std::string result(expected.size() + 32, '\0');
+            auto consumed = decoder.function(reinterpret_cast<const unsigned char *>(encoded.data()), encoded.size(),
+                                             result.data());
+
+            if (consumed % 4 != 0 || consumed > encoded.size() ||
+                result.compare(0, consumed / 4 * 3, reinterpret_cast<const char *>(expected.data()),
+                               consumed / 4 * 3) != 0)
+            {
+                fail(std::string(decoder.name) + " decoder, length " + std::to_string(encoded.size()));
+            }
+        }
+
+        const auto decoded = base64_decode(encoded);
+        if (decoded != std::string(expected.begin(), expected.end()))
+        {
+            fail("base64_decode, length " + std::to_string(encoded.size()));
+        }
+    }
+
+    void check(const std::vector<unsigned char> &input)
+    {
+        for (auto url : {false, true})
+        {
+            checkEncoders(input, url);
+            checkDecoders(scalarEncode(input, url), input);
+        }
+    }
+
+    std::vector<unsigned char> randomBytes(std::mt19937 &rng, std::size_t length)
+    {
+        std::uniform_int_distribution<int> byte(0, 255);
+
+        std::vector<unsigned char> rtn(length);
+        for (auto &item : rtn)
+        {
+            item = static_cast<unsigned char>(byte(rng));
+        }
+
+        return rtn;
+    }
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(0x5d);
+
+    //* Every tail length, on its own and behind enough input for the wide loops
+    for (std::size_t length = 0; 64 >= length; length++)
+    {
+        check(randomBytes(rng, length));
+        check(randomBytes(rng, 256 + length));
+    }
+
+    //* Lengths and contents the fixed ones above might miss
+    std::uniform_int_distribution<std::size_t> length(0, 4096);
+    for (int i = 0; 500 > i; i++)
+    {
+        check(randomBytes(rng, length(rng)));
+    }
+
+    //* Every byte value ends up in every position of a block
+    std::vector<unsigned char> all(3 * 256);
+    for (std::size_t i = 0; all.size() > i; i++)
+    {
+        all[i] = static_cast<unsigned char>(i / 3 + (i % 3) * 85);
+    }
+    check(all);
+
+    //* Both alphabets may be mixed in one input
+    auto input = randomBytes(rng, 300);
+    auto mixed = scalarEncode(input, false);
+    for (std::size_t i = 0; mixed.size() > i; i += 2)
+    {
+        if (mixed[i] == '+')
+            mixed[i] = '-';
+        else if (mixed[i] == '/')
+            mixed[i] = '_';
+    }
+    checkDecoders(mixed, input);
+
+    //* Unpadded input is accepted as well
+    input = randomBytes(rng, 301);
+    auto unpadded = scalarEncode(input, false);
+    unpadded.erase(unpadded.find_last_not_of('=') + 1);
+    checkDecoders(unpadded, input);
+
+    //* Invalid characters have to be reported no matter where they are
+    const auto valid = scalarEncode(randomBytes(rng, 300), false);
+    for (auto position : {std::size_t{0}, std::size_t{17}, std::size_t{40}, std::size_t{150}, valid.size() - 5})
+    {
+        for (auto invalid : {'*', '\0', '\x80', ' '})
+        {
+            auto broken = valid;
+            broken[position] = invalid;
+
+            try
+            {
+                base64_decode(broken);
+                fail("accepted invalid character at " + std::to_string(position));
+            }
+            catch (const std::runtime_error &)
+            {
+            }
+        }
+    }
+
+    std::cout << "Checked " << encoders().size() << " vectorized encoder(s) and " << decoders().size()
+              << " vectorized decoder(s)" << std::endl;
+
+    if (failures > 0)
+    {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}